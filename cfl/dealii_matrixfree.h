@@ -1,12 +1,18 @@
 #ifndef cfl_dealii_matrix_free_h
 #define cfl_dealii_matrix_free_h
 
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/point.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/lac/la_parallel_block_vector.h>
 
 #include <cfl/forms.h>
 #include <cfl/traits.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 #define AssertIndexInRange(index, range)                                                           \
@@ -35,7 +41,19 @@ namespace dealii
     template <typename... Types>
     class ProductFEFunctions;
     template <class FEFunctionType>
+    class NegatedFEFunction;
+    template <class FEFunctionType>
+    class ScaledFEFunction;
+    template <class FEFunctionType>
     class FELiftDivergence;
+    template <unsigned int N, class FEFunctionType>
+    class FEPower;
+    template <class FEFunctionType, std::size_t n_coefficients>
+    class FEPolynomial;
+    template <int rank, int dim, class Function, typename Number>
+    class Coefficient;
+    template <int rank, int dim, unsigned int idx>
+    class CellParameter;
   } // namespace MatrixFree
 } // namespace dealii
 
@@ -67,6 +85,21 @@ namespace Traits
     static const bool value = true;
   };
 
+  // scalar coefficients scaling tensor valued FEFunctions, see Coefficient
+  template <int dim, int rank, typename Number>
+  struct is_compatible<::dealii::VectorizedArray<Number>,
+                       ::dealii::Tensor<rank, dim, ::dealii::VectorizedArray<Number>>>
+  {
+    static const bool value = true;
+  };
+
+  template <int dim, int rank, typename Number>
+  struct is_compatible<::dealii::Tensor<rank, dim, ::dealii::VectorizedArray<Number>>,
+                       ::dealii::VectorizedArray<Number>>
+  {
+    static const bool value = true;
+  };
+
   template <typename... Types>
   struct is_cfl_object<dealii::MatrixFree::SumFEFunctions<Types...>>
   {
@@ -140,6 +173,30 @@ namespace Traits
     static const bool value = true;
   };
 
+  template <class FEFunctionType>
+  struct is_cfl_object<dealii::MatrixFree::NegatedFEFunction<FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
+  template <class FEFunctionType>
+  struct is_fe_function_set<dealii::MatrixFree::NegatedFEFunction<FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
+  template <class FEFunctionType>
+  struct is_cfl_object<dealii::MatrixFree::ScaledFEFunction<FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
+  template <class FEFunctionType>
+  struct is_fe_function_set<dealii::MatrixFree::ScaledFEFunction<FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
   template <class FEFunctionType>
   struct is_cfl_object<dealii::MatrixFree::FELiftDivergence<FEFunctionType>>
   {
@@ -152,6 +209,54 @@ namespace Traits
     static const bool value = true;
   };
 
+  template <unsigned int N, class FEFunctionType>
+  struct is_cfl_object<dealii::MatrixFree::FEPower<N, FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
+  template <unsigned int N, class FEFunctionType>
+  struct is_fe_function_set<dealii::MatrixFree::FEPower<N, FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
+  template <class FEFunctionType, std::size_t n_coefficients>
+  struct is_cfl_object<dealii::MatrixFree::FEPolynomial<FEFunctionType, n_coefficients>>
+  {
+    static const bool value = true;
+  };
+
+  template <class FEFunctionType, std::size_t n_coefficients>
+  struct is_fe_function_set<dealii::MatrixFree::FEPolynomial<FEFunctionType, n_coefficients>>
+  {
+    static const bool value = true;
+  };
+
+  template <int rank, int dim, class Function, typename Number>
+  struct is_cfl_object<dealii::MatrixFree::Coefficient<rank, dim, Function, Number>>
+  {
+    static const bool value = true;
+  };
+
+  template <int rank, int dim, class Function, typename Number>
+  struct is_fe_function_set<dealii::MatrixFree::Coefficient<rank, dim, Function, Number>>
+  {
+    static const bool value = true;
+  };
+
+  template <int rank, int dim, unsigned int idx>
+  struct is_cfl_object<dealii::MatrixFree::CellParameter<rank, dim, idx>>
+  {
+    static const bool value = true;
+  };
+
+  template <int rank, int dim, unsigned int idx>
+  struct is_fe_function_set<dealii::MatrixFree::CellParameter<rank, dim, idx>>
+  {
+    static const bool value = true;
+  };
+
   template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
   struct is_cfl_object<
     T<rank, dim, idx>,
@@ -170,6 +275,15 @@ namespace Traits
     static const bool value = true;
   };
 
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  struct is_fe_function_terminal<
+    T<rank, dim, idx>,
+    std::enable_if_t<std::is_base_of<dealii::MatrixFree::FEFunctionBase<T<rank, dim, idx>>,
+                                     T<rank, dim, idx>>::value>>
+  {
+    static const bool value = true;
+  };
+
   template <typename... Types>
   struct is_fe_function_set<dealii::MatrixFree::ProductFEFunctions<Types...>>
   {
@@ -212,6 +326,7 @@ namespace dealii
     {
     public:
       using Base = TestFunctionBase<TestFunction<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, false>;
       static constexpr bool integrate_value = true;
       static constexpr bool integrate_gradient = false;
 
@@ -237,6 +352,7 @@ namespace dealii
     {
     public:
       using Base = TestFunctionBase<TestDivergence<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, true>;
       static constexpr bool integrate_value = false;
       static constexpr bool integrate_gradient = true;
 
@@ -260,6 +376,7 @@ namespace dealii
     {
     public:
       using Base = TestFunctionBase<TestSymmetricGradient<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, true>;
       static constexpr bool integrate_value = false;
       static constexpr bool integrate_gradient = true;
 
@@ -284,6 +401,7 @@ namespace dealii
     {
     public:
       using Base = TestFunctionBase<TestCurl<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, true>;
       static constexpr bool integrate_value = false;
       static constexpr bool integrate_gradient = true;
 
@@ -309,6 +427,7 @@ namespace dealii
     {
     public:
       using Base = TestFunctionBase<TestGradient<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, true>;
       static constexpr bool integrate_value = false;
       static constexpr bool integrate_gradient = true;
 
@@ -372,184 +491,618 @@ namespace dealii
       return TestHessian<rank + 1, dim, idx>();
     }
 
-    // CRTP
-    template <class Derived>
-    class FEFunctionBase
+    /**
+     * The jump v^- - v^+ of the test functions over an interior face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class TestJump final : public TestFunctionBase<TestJump<rank, dim, idx>>
     {
     public:
-      // This class should never be constructed
-      FEFunctionBase() = delete;
+      using Base = TestFunctionBase<TestJump<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, false>;
+      static constexpr bool integrate_value = true;
+      static constexpr bool integrate_gradient = false;
+      static constexpr IntegrationDomain integration_domain = IntegrationDomain::face;
+
+      template <class FEEvaluation, typename ValueType>
+      static void
+      submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the TestJump is vector valued or "
+                      "the TestJump is scalar valued and "
+                      "the FiniteElement is vector valued!");
+#ifdef DEBUG_OUTPUT
+        std::cout << "submit TestJump " << Base::index << " " << q << std::endl;
+#endif
+        phi.template submit_jump<Base::index>(value, q);
+      }
     };
 
-    template <template <int, int, unsigned int> class Derived, int rank, int dim, unsigned int idx>
-    class FEFunctionBase<Derived<rank, dim, idx>>
+    /**
+     * The average of the test functions on both sides of an interior face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class TestAverage final : public TestFunctionBase<TestAverage<rank, dim, idx>>
     {
-    protected:
-      const std::string data_name;
-
     public:
-      using TensorTraits = Traits::Tensor<rank, dim>;
-      static constexpr unsigned int index = idx;
-      double scalar_factor = 1.;
-
-      FEFunctionBase() = delete;
+      using Base = TestFunctionBase<TestAverage<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, false>;
+      static constexpr bool integrate_value = true;
+      static constexpr bool integrate_gradient = false;
+      static constexpr IntegrationDomain integration_domain = IntegrationDomain::face;
 
-      explicit FEFunctionBase(const std::string name, double new_factor = 1.)
-        : data_name(std::move(name))
-        , scalar_factor(new_factor)
+      template <class FEEvaluation, typename ValueType>
+      static void
+      submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
       {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the TestAverage is vector valued or "
+                      "the TestAverage is scalar valued and "
+                      "the FiniteElement is vector valued!");
+#ifdef DEBUG_OUTPUT
+        std::cout << "submit TestAverage " << Base::index << " " << q << std::endl;
+#endif
+        phi.template submit_average<Base::index>(value, q);
       }
+    };
 
-      explicit FEFunctionBase(double new_factor = 1.)
-        : scalar_factor(new_factor)
-      {
-      }
+    /**
+     * The average of the normal derivatives of the test functions on both sides of an interior
+     * face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class TestNormalDerivative final : public TestFunctionBase<TestNormalDerivative<rank, dim, idx>>
+    {
+    public:
+      using Base = TestFunctionBase<TestNormalDerivative<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, true>;
+      static constexpr bool integrate_value = false;
+      static constexpr bool integrate_gradient = true;
+      static constexpr IntegrationDomain integration_domain = IntegrationDomain::face;
 
-      const std::string&
-      name() const
+      template <class FEEvaluation, typename ValueType>
+      static void
+      submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
       {
-        return data_name;
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the TestNormalDerivative is vector valued or "
+                      "the TestNormalDerivative is scalar valued and "
+                      "the FiniteElement is vector valued!");
+#ifdef DEBUG_OUTPUT
+        std::cout << "submit TestNormalDerivative " << Base::index << " " << q << std::endl;
+#endif
+        phi.template submit_normal_derivative<Base::index>(value, q);
       }
+    };
 
-      template <typename Number>
-      typename std::enable_if_t<std::is_arithmetic<Number>::value, Derived<rank, dim, idx>>
-      operator*(const Number scalar_factor_) const
-      {
-        return Derived<rank, dim, idx>(data_name, scalar_factor * scalar_factor_);
-      }
+    /**
+     * The test functions on a boundary face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class TestBoundaryValue final : public TestFunctionBase<TestBoundaryValue<rank, dim, idx>>
+    {
+    public:
+      using Base = TestFunctionBase<TestBoundaryValue<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, false>;
+      static constexpr bool integrate_value = true;
+      static constexpr bool integrate_gradient = false;
+      static constexpr IntegrationDomain integration_domain = IntegrationDomain::boundary;
 
-      Derived<rank, dim, idx>
-      operator-() const
+      template <class FEEvaluation, typename ValueType>
+      static void
+      submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
       {
-        const Derived<rank, dim, idx> newfunction(-scalar_factor);
-        return newfunction;
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the TestBoundaryValue is vector valued or "
+                      "the TestBoundaryValue is scalar valued and "
+                      "the FiniteElement is vector valued!");
+#ifdef DEBUG_OUTPUT
+        std::cout << "submit TestBoundaryValue " << Base::index << " " << q << std::endl;
+#endif
+        phi.template submit_boundary_value<Base::index>(value, q);
       }
     };
 
+    /**
+     * The normal derivative of the test functions on a boundary face.
+     */
     template <int rank, int dim, unsigned int idx>
-    class FEFunction final : public FEFunctionBase<FEFunction<rank, dim, idx>>
+    class TestBoundaryNormalDerivative final
+      : public TestFunctionBase<TestBoundaryNormalDerivative<rank, dim, idx>>
     {
     public:
-      using Base = FEFunctionBase<FEFunction<rank, dim, idx>>;
-      // inherit constructors
-      using Base::Base;
-
-      template <class FEDatas>
-      auto
-      value(const FEDatas& phi, unsigned int q) const
-      {
-        return Base::scalar_factor * phi.template get_value<Base::index>(q);
-      }
+      using Base = TestFunctionBase<TestBoundaryNormalDerivative<rank, dim, idx>>;
+      using Slot = SubmissionSlot<idx, true>;
+      static constexpr bool integrate_value = false;
+      static constexpr bool integrate_gradient = true;
+      static constexpr IntegrationDomain integration_domain = IntegrationDomain::boundary;
 
-      template <class FEEvaluation>
+      template <class FEEvaluation, typename ValueType>
       static void
-      set_evaluation_flags(FEEvaluation& phi)
+      submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
       {
         static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
                         (Base::TensorTraits::rank > 0),
                       "Either the proposed FiniteElement is scalar valued "
-                      "and the FEFunction is vector valued or "
-                      "the FEFunction is scalar valued and "
+                      "and the TestBoundaryNormalDerivative is vector valued or "
+                      "the TestBoundaryNormalDerivative is scalar valued and "
                       "the FiniteElement is vector valued!");
-        phi.template set_evaluation_flags<Base::index>(true, false, false);
+#ifdef DEBUG_OUTPUT
+        std::cout << "submit TestBoundaryNormalDerivative " << Base::index << " " << q << std::endl;
+#endif
+        phi.template submit_normal_derivative<Base::index>(value, q);
       }
     };
 
     template <int rank, int dim, unsigned int idx>
-    class FEDivergence final : public FEFunctionBase<FEDivergence<rank, dim, idx>>
+    TestJump<rank, dim, idx>
+    jump(const TestFunction<rank, dim, idx>& /*unused*/)
     {
-    public:
-      using Base = FEFunctionBase<FEDivergence<rank, dim, idx>>;
-      // inherit constructors
-      using Base::Base;
+      return TestJump<rank, dim, idx>();
+    }
 
-      explicit FEDivergence(const FEFunction<rank + 1, dim, idx>& fefunction)
-        : FEDivergence(fefunction.name(), fefunction.scalar_factor)
-      {
-      }
+    template <int rank, int dim, unsigned int idx>
+    TestAverage<rank, dim, idx>
+    average(const TestFunction<rank, dim, idx>& /*unused*/)
+    {
+      return TestAverage<rank, dim, idx>();
+    }
 
-      template <class FEDatas>
-      auto
-      value(const FEDatas& phi, unsigned int q) const
-      {
-        return Base::scalar_factor * phi.template get_divergence<Base::index>(q);
-      }
+    template <int rank, int dim, unsigned int idx>
+    TestNormalDerivative<rank, dim, idx>
+    normal_derivative(const TestFunction<rank, dim, idx>& /*unused*/)
+    {
+      return TestNormalDerivative<rank, dim, idx>();
+    }
 
-      template <class FEEvaluation>
-      static void
-      set_evaluation_flags(FEEvaluation& phi)
-      {
-        static_assert(FEEvaluation::template rank<Base::index>() > 0,
-                      "The proposed FiniteElement has to be "
-                      "vector valued for using FEDivergence!");
-        phi.template set_evaluation_flags<Base::index>(false, true, false);
-      }
-    };
+    template <int rank, int dim, unsigned int idx>
+    TestBoundaryValue<rank, dim, idx>
+    boundary_value(const TestFunction<rank, dim, idx>& /*unused*/)
+    {
+      return TestBoundaryValue<rank, dim, idx>();
+    }
 
-    template <class FEFunctionType>
-    class FELiftDivergence final
+    template <int rank, int dim, unsigned int idx>
+    TestBoundaryNormalDerivative<rank, dim, idx>
+    boundary_normal_derivative(const TestFunction<rank, dim, idx>& /*unused*/)
     {
-    private:
-      const FEFunctionType fefunction;
+      return TestBoundaryNormalDerivative<rank, dim, idx>();
+    }
 
-    public:
-      using TensorTraits =
-        Traits::Tensor<FEFunctionType::TensorTraits::rank + 2, FEFunctionType::TensorTraits::dim>;
-      static constexpr unsigned int index = FEFunctionType::idx;
+    namespace internal
+    {
+      // x^N by square-and-multiply, unrolled at compile time
+      template <unsigned int N, typename Value>
+      Value
+      power(const Value& x)
+      {
+        static_assert(N > 0, "Only positive exponents are supported!");
+        if constexpr(N == 1)
+          return x;
+        else if constexpr(N % 2 == 0)
+        {
+          const Value root = power<N / 2>(x);
+          return root * root;
+        }
+        else
+          return x * power<N - 1>(x);
+      }
 
-      explicit FELiftDivergence(const FEFunctionType fe_function)
-        : fefunction(std::move(fe_function))
+      // the number of VectorizedArray entries of a scalar or a Tensor of VectorizedArray
+      template <typename Value>
+      struct n_components
+      {
+        static constexpr unsigned int value = 1;
+      };
+
+      template <int rank, int dim, typename Value>
+      struct n_components<::dealii::Tensor<rank, dim, Value>>
       {
+        static constexpr unsigned int value =
+          dim * n_components<std::decay_t<decltype(
+                  std::declval<const ::dealii::Tensor<rank, dim, Value>&>()[0])>>::value;
+      };
+
+      // copy the entries of @p value to @p data, the last tensor index running fastest
+      template <typename Value, typename Number>
+      void
+      to_components(const Value& value, ::dealii::VectorizedArray<Number>* data)
+      {
+        *data = value;
       }
 
-      template <class FEDatas>
-      auto
-      value(const FEDatas& phi, unsigned int q) const
+      template <int rank, int dim, typename Value, typename Number>
+      void
+      to_components(const ::dealii::Tensor<rank, dim, Value>& value,
+                    ::dealii::VectorizedArray<Number>* data)
       {
-        auto value = fefunction.value(phi, q);
-        ::dealii::Tensor<TensorTraits::rank, TensorTraits::dim, decltype(value)> lifted_tensor;
-        for (unsigned int i = 0; i < TensorTraits::dim; ++i)
-        {
-          lifted_tensor[i][i] = value;
-        }
-        return lifted_tensor;
+        constexpr unsigned int stride = n_components<std::decay_t<decltype(value[0])>>::value;
+        for (unsigned int d = 0; d < dim; ++d)
+          to_components(value[d], data + d * stride);
       }
 
-      auto
-      operator-() const
+      // the inverse of to_components()
+      template <typename Value, typename Number>
+      void
+      from_components(const ::dealii::VectorizedArray<Number>* data, Value& value)
       {
-        return FELiftDivergence(-fefunction);
+        value = *data;
       }
 
-      template <typename Number>
-      typename std::enable_if_t<std::is_arithmetic<Number>::value, FELiftDivergence<FEFunctionType>>
-      operator*(const Number scalar_factor_) const
+      template <int rank, int dim, typename Value, typename Number>
+      void
+      from_components(const ::dealii::VectorizedArray<Number>* data,
+                      ::dealii::Tensor<rank, dim, Value>& value)
       {
-        return FELiftDivergence<FEFunctionType>(
-          FEFunctionType(fefunction.name(), fefunction.scalar_value * scalar_factor_));
+        constexpr unsigned int stride = n_components<std::decay_t<decltype(value[0])>>::value;
+        for (unsigned int d = 0; d < dim; ++d)
+          from_components(data + d * stride, value[d]);
       }
 
-      template <class FEEvaluation>
-      static void
-      set_evaluation_flags(FEEvaluation& phi)
+      // a new id for each Coefficient constructed from a function, kept by its copies
+      inline unsigned int
+      new_coefficient_id()
       {
-        FEFunctionType::set_evaluation_flags(phi);
+        static std::atomic<unsigned int> next_id{ 0 };
+        return next_id++;
       }
-    };
 
-    template <int rank, int dim, unsigned int idx>
-    class FESymmetricGradient final : public FEFunctionBase<FESymmetricGradient<rank, dim, idx>>
-    {
-    public:
-      using Base = FEFunctionBase<FESymmetricGradient<rank, dim, idx>>;
-      // inherit constructors
-      using Base::Base;
+      template <class T>
+      struct is_negated : std::false_type
+      {
+      };
+
+      template <class FEFunctionType>
+      struct is_negated<NegatedFEFunction<FEFunctionType>> : std::true_type
+      {
+      };
+
+      template <class T>
+      struct is_scaled : std::false_type
+      {
+      };
+
+      template <class FEFunctionType>
+      struct is_scaled<ScaledFEFunction<FEFunctionType>> : std::true_type
+      {
+      };
+
+      // true for the expressions carrying a scalar factor other than one
+      template <class T>
+      using has_scalar_factor =
+        std::integral_constant<bool, is_negated<T>::value || is_scaled<T>::value>;
+
+      // @p f without its scalar factor
+      template <class T>
+      const auto&
+      unscaled(const T& f)
+      {
+        if constexpr(has_scalar_factor<T>::value)
+          return f.get_unscaled();
+        else
+          return f;
+      }
+
+      template <class T>
+      double
+      get_scalar_factor(const T& f)
+      {
+        if constexpr(has_scalar_factor<T>::value)
+          return f.scalar_factor;
+        else
+          return 1.;
+      }
+
+      template <class T>
+      using unscaled_t = std::decay_t<decltype(unscaled(std::declval<const T&>()))>;
+
+      template <class T>
+      using negated_t = std::decay_t<decltype(-std::declval<const T&>())>;
+
+      template <class T>
+      using scaled_t = std::decay_t<decltype(std::declval<const T&>() * 1.)>;
+    } // namespace internal
+
+    /**
+     * The FEFunction object @p FEFunctionType times -1. Like the unit factor of all other
+     * objects, the sign is part of the type and costs no multiplication: the value is negated,
+     * SumFEFunctions subtracts it instead, and the signs of factors are moved out of products,
+     * so u * (-e) is -(u * e). Negating again gives back @p FEFunctionType.
+     */
+    template <class FEFunctionType>
+    class NegatedFEFunction final
+    {
+    public:
+      using TensorTraits = typename FEFunctionType::TensorTraits;
+      static constexpr double scalar_factor = -1.;
+
+      explicit NegatedFEFunction(const FEFunctionType& fe_function_)
+        : fe_function(fe_function_)
+      {
+        static_assert(!internal::has_scalar_factor<FEFunctionType>::value,
+                      "The scalar factors of an expression are combined into one!");
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return -fe_function.value(phi, q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        FEFunctionType::set_evaluation_flags(phi);
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value,
+                                ScaledFEFunction<FEFunctionType>>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction<FEFunctionType>(fe_function, -double(scalar_factor_));
+      }
+
+      FEFunctionType
+      operator-() const
+      {
+        return fe_function;
+      }
+
+      const FEFunctionType&
+      get_unscaled() const
+      {
+        return fe_function;
+      }
+
+    private:
+      const FEFunctionType fe_function;
+    };
+
+    /**
+     * The FEFunction object @p FEFunctionType times a scalar factor given at runtime, e.g.
+     * 3 * u. Products move it outwards as well, so 3 * u * u * e costs one multiplication by 3
+     * in addition to the products of the values, and further numbers are multiplied into the
+     * same scalar factor.
+     */
+    template <class FEFunctionType>
+    class ScaledFEFunction final
+    {
+    public:
+      using TensorTraits = typename FEFunctionType::TensorTraits;
+      double scalar_factor;
+
+      ScaledFEFunction(const FEFunctionType& fe_function_, const double new_factor)
+        : scalar_factor(new_factor)
+        , fe_function(fe_function_)
+      {
+        static_assert(!internal::has_scalar_factor<FEFunctionType>::value,
+                      "The scalar factors of an expression are combined into one!");
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return scalar_factor * fe_function.value(phi, q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        FEFunctionType::set_evaluation_flags(phi);
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value, ScaledFEFunction>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction(fe_function, scalar_factor * scalar_factor_);
+      }
+
+      ScaledFEFunction
+      operator-() const
+      {
+        return ScaledFEFunction(fe_function, -scalar_factor);
+      }
+
+      const FEFunctionType&
+      get_unscaled() const
+      {
+        return fe_function;
+      }
+
+    private:
+      const FEFunctionType fe_function;
+    };
+
+    // CRTP
+    template <class Derived>
+    class FEFunctionBase
+    {
+    public:
+      // This class should never be constructed
+      FEFunctionBase() = delete;
+    };
+
+    template <template <int, int, unsigned int> class Derived, int rank, int dim, unsigned int idx>
+    class FEFunctionBase<Derived<rank, dim, idx>>
+    {
+    protected:
+      const std::string data_name;
+
+    public:
+      using TensorTraits = Traits::Tensor<rank, dim>;
+      static constexpr unsigned int index = idx;
+      // scalar factors other than one are kept by NegatedFEFunction and ScaledFEFunction
+      static constexpr double scalar_factor = 1.;
+
+      FEFunctionBase() = delete;
+
+      explicit FEFunctionBase(const std::string name)
+        : data_name(std::move(name))
+      {
+      }
+
+      const std::string&
+      name() const
+      {
+        return data_name;
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value,
+                                ScaledFEFunction<Derived<rank, dim, idx>>>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction<Derived<rank, dim, idx>>(
+          static_cast<const Derived<rank, dim, idx>&>(*this), scalar_factor_);
+      }
+
+      NegatedFEFunction<Derived<rank, dim, idx>>
+      operator-() const
+      {
+        return NegatedFEFunction<Derived<rank, dim, idx>>(
+          static_cast<const Derived<rank, dim, idx>&>(*this));
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FEFunction final : public FEFunctionBase<FEFunction<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEFunction<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
 
       template <class FEDatas>
       auto
       value(const FEDatas& phi, unsigned int q) const
       {
-        return Base::scalar_factor * phi.template get_symmetric_gradient<Base::index>(q);
+        return phi.template get_value<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEFunction is vector valued or "
+                      "the FEFunction is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(true, false, false);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FEDivergence final : public FEFunctionBase<FEDivergence<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEDivergence<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FEDivergence(const FEFunction<rank + 1, dim, idx>& fefunction)
+        : FEDivergence(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_divergence<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert(FEEvaluation::template rank<Base::index>() > 0,
+                      "The proposed FiniteElement has to be "
+                      "vector valued for using FEDivergence!");
+        phi.template set_evaluation_flags<Base::index>(false, true, false);
+      }
+    };
+
+    template <class FEFunctionType>
+    class FELiftDivergence final
+    {
+    private:
+      const FEFunctionType fefunction;
+
+    public:
+      using TensorTraits =
+        Traits::Tensor<FEFunctionType::TensorTraits::rank + 2, FEFunctionType::TensorTraits::dim>;
+      static constexpr unsigned int index = FEFunctionType::idx;
+
+      explicit FELiftDivergence(const FEFunctionType fe_function)
+        : fefunction(std::move(fe_function))
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        auto value = fefunction.value(phi, q);
+        ::dealii::Tensor<TensorTraits::rank, TensorTraits::dim, decltype(value)> lifted_tensor;
+        for (unsigned int i = 0; i < TensorTraits::dim; ++i)
+        {
+          lifted_tensor[i][i] = value;
+        }
+        return lifted_tensor;
+      }
+
+      NegatedFEFunction<FELiftDivergence>
+      operator-() const
+      {
+        return NegatedFEFunction<FELiftDivergence>(*this);
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value,
+                                ScaledFEFunction<FELiftDivergence>>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction<FELiftDivergence>(*this, scalar_factor_);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        FEFunctionType::set_evaluation_flags(phi);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FESymmetricGradient final : public FEFunctionBase<FESymmetricGradient<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FESymmetricGradient<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_symmetric_gradient<Base::index>(q);
       }
 
       template <class FEEvaluation>
@@ -575,7 +1128,315 @@ namespace dealii
       using Base::Base;
 
       explicit FECurl(const FEFunction<rank - 1, dim, idx>& fefunction)
-        : FECurl(fefunction.name(), fefunction.scalar_factor)
+        : FECurl(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_curl<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 1),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEGradient is vector valued or "
+                      "the FEGradient is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(false, true, false);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FEGradient final : public FEFunctionBase<FEGradient<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEGradient<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FEGradient(const FEFunction<rank - 1, dim, idx>& fefunction)
+        : FEGradient(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_gradient<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 1),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEGradient is vector valued or "
+                      "the FEGradient is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(false, true, false);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FELaplacian final : public FEFunctionBase<FELaplacian<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FELaplacian<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FELaplacian(const FEGradient<rank + 1, dim, idx>& fe_function)
+        : FELaplacian(fe_function.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_laplacian<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 2),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEHessian is vector valued or "
+                      "the FEHessian is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(false, false, true);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FEDiagonalHessian final : public FEFunctionBase<FEDiagonalHessian<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEDiagonalHessian<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_hessian_diagonal<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 2),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEHessian is vector valued or "
+                      "the FEHessian is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(false, false, true);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    class FEHessian final : public FEFunctionBase<FEHessian<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEHessian<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FEHessian(const FEGradient<rank - 1, dim, idx>& fefunction)
+        : FEHessian(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_hessian<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 2),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEHessian is vector valued or "
+                      "the FEHessian is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(false, false, true);
+      }
+    };
+
+    template <int rank, int dim, unsigned int idx>
+    FEGradient<rank + 1, dim, idx>
+    grad(const FEFunction<rank, dim, idx>& f)
+    {
+      return FEGradient<rank + 1, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FEDivergence<rank - 1, dim, idx>
+    div(const FEFunction<rank, dim, idx>& f)
+    {
+      return FEDivergence<rank - 1, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FEHessian<rank + 1, dim, idx>
+    grad(const FEGradient<rank, dim, idx>& f)
+    {
+      return FEHessian<rank + 1, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FELaplacian<rank - 1, dim, idx>
+    div(const FEGradient<rank, dim, idx>& f)
+    {
+      return FELaplacian<rank - 1, dim, idx>(f);
+    }
+
+    /**
+     * The jump u^- - u^+ of a finite element function over an interior face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class FEJump final : public FEFunctionBase<FEJump<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEJump<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FEJump(const FEFunction<rank, dim, idx>& fefunction)
+        : FEJump(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_jump<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEJump is vector valued or "
+                      "the FEJump is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(true, false);
+      }
+    };
+
+    /**
+     * The average of a finite element function on both sides of an interior face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class FEAverage final : public FEFunctionBase<FEAverage<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEAverage<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FEAverage(const FEFunction<rank, dim, idx>& fefunction)
+        : FEAverage(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_average<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FEAverage is vector valued or "
+                      "the FEAverage is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(true, false);
+      }
+    };
+
+    /**
+     * The average of the normal derivatives of a finite element function on both sides of an
+     * interior face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class FENormalDerivative final : public FEFunctionBase<FENormalDerivative<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FENormalDerivative<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FENormalDerivative(const FEFunction<rank, dim, idx>& fefunction)
+        : FENormalDerivative(fefunction.name())
+      {
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return phi.template get_normal_derivative<Base::index>(q);
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
+                        (Base::TensorTraits::rank > 0),
+                      "Either the proposed FiniteElement is scalar valued "
+                      "and the FENormalDerivative is vector valued or "
+                      "the FENormalDerivative is scalar valued and "
+                      "the FiniteElement is vector valued!");
+        phi.template set_evaluation_flags<Base::index>(false, true);
+      }
+    };
+
+    /**
+     * The value of a finite element function on a boundary face.
+     */
+    template <int rank, int dim, unsigned int idx>
+    class FEBoundaryValue final : public FEFunctionBase<FEBoundaryValue<rank, dim, idx>>
+    {
+    public:
+      using Base = FEFunctionBase<FEBoundaryValue<rank, dim, idx>>;
+      // inherit constructors
+      using Base::Base;
+
+      explicit FEBoundaryValue(const FEFunction<rank, dim, idx>& fefunction)
+        : FEBoundaryValue(fefunction.name())
       {
       }
 
@@ -583,7 +1444,7 @@ namespace dealii
       auto
       value(const FEDatas& phi, unsigned int q) const
       {
-        return Base::scalar_factor * phi.template get_curl<Base::index>(q);
+        return phi.template get_boundary_value<Base::index>(q);
       }
 
       template <class FEEvaluation>
@@ -591,25 +1452,29 @@ namespace dealii
       set_evaluation_flags(FEEvaluation& phi)
       {
         static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
-                        (Base::TensorTraits::rank > 1),
+                        (Base::TensorTraits::rank > 0),
                       "Either the proposed FiniteElement is scalar valued "
-                      "and the FEGradient is vector valued or "
-                      "the FEGradient is scalar valued and "
+                      "and the FEBoundaryValue is vector valued or "
+                      "the FEBoundaryValue is scalar valued and "
                       "the FiniteElement is vector valued!");
-        phi.template set_evaluation_flags<Base::index>(false, true, false);
+        phi.template set_evaluation_flags<Base::index>(true, false);
       }
     };
 
+    /**
+     * The normal derivative of a finite element function on a boundary face.
+     */
     template <int rank, int dim, unsigned int idx>
-    class FEGradient final : public FEFunctionBase<FEGradient<rank, dim, idx>>
+    class FEBoundaryNormalDerivative final
+      : public FEFunctionBase<FEBoundaryNormalDerivative<rank, dim, idx>>
     {
     public:
-      using Base = FEFunctionBase<FEGradient<rank, dim, idx>>;
+      using Base = FEFunctionBase<FEBoundaryNormalDerivative<rank, dim, idx>>;
       // inherit constructors
       using Base::Base;
 
-      explicit FEGradient(const FEFunction<rank - 1, dim, idx>& fefunction)
-        : FEGradient(fefunction.name(), fefunction.scalar_factor)
+      explicit FEBoundaryNormalDerivative(const FEFunction<rank, dim, idx>& fefunction)
+        : FEBoundaryNormalDerivative(fefunction.name())
       {
       }
 
@@ -617,7 +1482,7 @@ namespace dealii
       auto
       value(const FEDatas& phi, unsigned int q) const
       {
-        return Base::scalar_factor * phi.template get_gradient<Base::index>(q);
+        return phi.template get_normal_derivative<Base::index>(q);
       }
 
       template <class FEEvaluation>
@@ -625,88 +1490,284 @@ namespace dealii
       set_evaluation_flags(FEEvaluation& phi)
       {
         static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
-                        (Base::TensorTraits::rank > 1),
+                        (Base::TensorTraits::rank > 0),
                       "Either the proposed FiniteElement is scalar valued "
-                      "and the FEGradient is vector valued or "
-                      "the FEGradient is scalar valued and "
+                      "and the FEBoundaryNormalDerivative is vector valued or "
+                      "the FEBoundaryNormalDerivative is scalar valued and "
                       "the FiniteElement is vector valued!");
-        phi.template set_evaluation_flags<Base::index>(false, true, false);
+        phi.template set_evaluation_flags<Base::index>(false, true);
       }
     };
 
     template <int rank, int dim, unsigned int idx>
-    class FELaplacian final : public FEFunctionBase<FELaplacian<rank, dim, idx>>
+    FEJump<rank, dim, idx>
+    jump(const FEFunction<rank, dim, idx>& f)
+    {
+      return FEJump<rank, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FEAverage<rank, dim, idx>
+    average(const FEFunction<rank, dim, idx>& f)
+    {
+      return FEAverage<rank, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FENormalDerivative<rank, dim, idx>
+    normal_derivative(const FEFunction<rank, dim, idx>& f)
+    {
+      return FENormalDerivative<rank, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FEBoundaryValue<rank, dim, idx>
+    boundary_value(const FEFunction<rank, dim, idx>& f)
+    {
+      return FEBoundaryValue<rank, dim, idx>(f);
+    }
+
+    template <int rank, int dim, unsigned int idx>
+    FEBoundaryNormalDerivative<rank, dim, idx>
+    boundary_normal_derivative(const FEFunction<rank, dim, idx>& f)
+    {
+      return FEBoundaryNormalDerivative<rank, dim, idx>(f);
+    }
+
+    /**
+     * The @p N-th power of a scalar valued FEFunction object, see pow(). The value is read once
+     * per quadrature point and raised to the power by square-and-multiply, e.g. u^3 takes two
+     * multiplications instead of the three factors of u*u*u.
+     */
+    template <unsigned int N, class FEFunctionType>
+    class FEPower final
     {
     public:
-      using Base = FEFunctionBase<FELaplacian<rank, dim, idx>>;
-      // inherit constructors
-      using Base::Base;
+      using TensorTraits = typename FEFunctionType::TensorTraits;
+      static constexpr unsigned int index = FEFunctionType::index;
+      static constexpr unsigned int exponent = N;
 
-      explicit FELaplacian(const FEGradient<rank + 1, dim, idx>& fe_function)
-        : FELaplacian(fe_function.name(), fe_function.scalar_factor)
+      explicit FEPower(const FEFunctionType& fe_function_)
+        : fe_function(fe_function_)
       {
+        static_assert(N > 1, "pow<1>(f) is f itself!");
+        static_assert(Traits::is_fe_function_terminal<FEFunctionType>::value,
+                      "Only powers of FEFunction objects are supported!");
+        static_assert(TensorTraits::rank == 0, "Only scalar valued FEFunctions can be raised!");
       }
 
       template <class FEDatas>
       auto
       value(const FEDatas& phi, unsigned int q) const
       {
-        return Base::scalar_factor * phi.template get_laplacian<Base::index>(q);
+        return internal::power<N>(fe_function.value(phi, q));
       }
 
       template <class FEEvaluation>
       static void
       set_evaluation_flags(FEEvaluation& phi)
       {
-        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
-                        (Base::TensorTraits::rank > 2),
-                      "Either the proposed FiniteElement is scalar valued "
-                      "and the FEHessian is vector valued or "
-                      "the FEHessian is scalar valued and "
-                      "the FiniteElement is vector valued!");
-        phi.template set_evaluation_flags<Base::index>(false, false, true);
+        FEFunctionType::set_evaluation_flags(phi);
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value, ScaledFEFunction<FEPower>>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction<FEPower>(*this, scalar_factor_);
+      }
+
+      NegatedFEFunction<FEPower>
+      operator-() const
+      {
+        return NegatedFEFunction<FEPower>(*this);
+      }
+
+      // the FEFunction raised to the power
+      const FEFunctionType&
+      get_fe_function() const
+      {
+        return fe_function;
+      }
+
+      // the derivative with respect to the FEFunction, used by linearize
+      auto
+      outer_derivative() const
+      {
+        if constexpr(N == 2)
+          return fe_function * 2.;
+        else
+          return FEPower<N - 1, FEFunctionType>(fe_function) * double(N);
       }
+
+    private:
+      const FEFunctionType fe_function;
     };
 
-    template <int rank, int dim, unsigned int idx>
-    class FEDiagonalHessian final : public FEFunctionBase<FEDiagonalHessian<rank, dim, idx>>
+    /**
+     * @p f to the power of @p N. The scalar factor of @p f is raised to the power once here, and
+     * the power of a negated @p f is negated for odd @p N only.
+     */
+    template <unsigned int N, class FEFunctionType>
+    auto
+    pow(const FEFunctionType& f)
+    {
+      static_assert(N > 0, "Only positive exponents are supported!");
+      using UnitType = internal::unscaled_t<FEFunctionType>;
+      if constexpr(N == 1)
+        return f;
+      else if constexpr(internal::is_negated<FEFunctionType>::value && N % 2 == 0)
+        return FEPower<N, UnitType>(f.get_unscaled());
+      else if constexpr(internal::is_negated<FEFunctionType>::value)
+        return -FEPower<N, UnitType>(f.get_unscaled());
+      else if constexpr(internal::is_scaled<FEFunctionType>::value)
+        return FEPower<N, UnitType>(f.get_unscaled()) * internal::power<N>(f.scalar_factor);
+      else
+        return FEPower<N, FEFunctionType>(f);
+    }
+
+    /**
+     * The polynomial c_0 + c_1 u + ... + c_n u^n in a scalar valued FEFunction object u, see
+     * polynomial(). The value of u is read once per quadrature point and the polynomial is
+     * evaluated by the Horner scheme. Scalar factors are folded into the coefficients.
+     */
+    template <class FEFunctionType, std::size_t n_coefficients>
+    class FEPolynomial final
     {
     public:
-      using Base = FEFunctionBase<FEDiagonalHessian<rank, dim, idx>>;
-      // inherit constructors
-      using Base::Base;
+      using TensorTraits = typename FEFunctionType::TensorTraits;
+      static constexpr unsigned int index = FEFunctionType::index;
+      static constexpr unsigned int degree = n_coefficients - 1;
+
+      FEPolynomial(const FEFunctionType& fe_function_,
+                   const std::array<double, n_coefficients>& coefficients_)
+        : fe_function(fe_function_)
+        , coefficients(coefficients_)
+      {
+        static_assert(n_coefficients > 1, "The polynomial needs to have at least degree one!");
+        static_assert(Traits::is_fe_function_terminal<FEFunctionType>::value,
+                      "Only polynomials in FEFunction objects are supported!");
+        static_assert(TensorTraits::rank == 0,
+                      "Only polynomials in scalar valued FEFunctions are supported!");
+      }
 
       template <class FEDatas>
       auto
       value(const FEDatas& phi, unsigned int q) const
       {
-        return Base::scalar_factor * phi.template get_hessian_diagonal<Base::index>(q);
+        const auto x = fe_function.value(phi, q);
+        auto result = coefficients[degree] * x + coefficients[degree - 1];
+        for (unsigned int i = degree - 1; i-- > 0;)
+          result = result * x + coefficients[i];
+        return result;
       }
 
       template <class FEEvaluation>
       static void
       set_evaluation_flags(FEEvaluation& phi)
       {
-        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
-                        (Base::TensorTraits::rank > 2),
-                      "Either the proposed FiniteElement is scalar valued "
-                      "and the FEHessian is vector valued or "
-                      "the FEHessian is scalar valued and "
-                      "the FiniteElement is vector valued!");
-        phi.template set_evaluation_flags<Base::index>(false, false, true);
+        FEFunctionType::set_evaluation_flags(phi);
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value, FEPolynomial>
+      operator*(const Number scalar_factor) const
+      {
+        std::array<double, n_coefficients> scaled_coefficients = coefficients;
+        for (auto& coefficient : scaled_coefficients)
+          coefficient *= scalar_factor;
+        return FEPolynomial(fe_function, scaled_coefficients);
+      }
+
+      FEPolynomial
+      operator-() const
+      {
+        return *this * -1.;
+      }
+
+      // the variable of the polynomial
+      const FEFunctionType&
+      get_fe_function() const
+      {
+        return fe_function;
+      }
+
+      const std::array<double, n_coefficients>&
+      get_coefficients() const
+      {
+        return coefficients;
+      }
+
+      // the derivative with respect to the FEFunction, used by linearize
+      auto
+      outer_derivative() const
+      {
+        if constexpr(n_coefficients == 2)
+          return coefficients[1];
+        else
+        {
+          std::array<double, n_coefficients - 1> derived_coefficients;
+          for (unsigned int i = 1; i < n_coefficients; ++i)
+            derived_coefficients[i - 1] = i * coefficients[i];
+          return FEPolynomial<FEFunctionType, n_coefficients - 1>(fe_function,
+                                                                  derived_coefficients);
+        }
       }
+
+    private:
+      const FEFunctionType fe_function;
+      const std::array<double, n_coefficients> coefficients;
     };
 
-    template <int rank, int dim, unsigned int idx>
-    class FEHessian final : public FEFunctionBase<FEHessian<rank, dim, idx>>
+    /**
+     * The polynomial @p coefficients[0] + @p coefficients[1] * f + ... in @p f, e.g.
+     * polynomial(u, 0., alpha, 0., -1.) for alpha*u - u^3. The scalar factor of @p f is folded
+     * into the coefficients here.
+     */
+    template <class FEFunctionType, typename... Numbers>
+    FEPolynomial<internal::unscaled_t<FEFunctionType>, sizeof...(Numbers)>
+    polynomial(const FEFunctionType& f, const Numbers... coefficients)
+    {
+      static_assert((true && ... && std::is_arithmetic<Numbers>::value),
+                    "The coefficients have to be numbers!");
+      std::array<double, sizeof...(Numbers)> scaled_coefficients{ { double(coefficients)... } };
+      double factor = 1.;
+      for (auto& coefficient : scaled_coefficients)
+      {
+        coefficient *= factor;
+        factor *= internal::get_scalar_factor(f);
+      }
+      using UnitType = internal::unscaled_t<FEFunctionType>;
+      return FEPolynomial<UnitType, sizeof...(Numbers)>(internal::unscaled(f), scaled_coefficients);
+    }
+
+    /**
+     * A coefficient given by a function of the quadrature points, e.g. a spatially varying
+     * diffusivity. @p Function is called with the Point<dim, VectorizedArray<Number>> of all lanes
+     * of a cell batch at once and returns a scalar or a Tensor of rank @p rank. A scalar may also
+     * scale FEFunction objects of higher rank, e.g. k * grad(u) with a Coefficient of rank one.
+     * The MatrixFree object needs update_quadrature_points, only cell terms are supported.
+     *
+     * Coefficients not depending on time can be evaluated once at setup by
+     * MatrixFreeIntegratorBase::cache_coefficient(). The operator then keeps the values per cell
+     * batch and quadrature point and FEDatas::get_coefficient_values() provides them instead of
+     * calling @p Function. They are found by get_id(), which all copies of a Coefficient share,
+     * e.g. the ones in the Forms of the operators on all multigrid levels. Each operator stores
+     * its own values, operators without cached values call @p Function.
+     */
+    template <int rank, int dim, class Function, typename Number = double>
+    class Coefficient final
     {
     public:
-      using Base = FEFunctionBase<FEHessian<rank, dim, idx>>;
-      // inherit constructors
-      using Base::Base;
+      using TensorTraits = Traits::Tensor<rank, dim>;
+      using PointType = ::dealii::Point<dim, ::dealii::VectorizedArray<Number>>;
+      using value_type = std::decay_t<decltype(
+        std::declval<const Function&>()(std::declval<const PointType&>()))>;
+      // the number of VectorizedArray entries stored per quadrature point when cached
+      static constexpr unsigned int n_components = internal::n_components<value_type>::value;
 
-      explicit FEHessian(const FEGradient<rank - 1, dim, idx>& fefunction)
-        : FEHessian(fefunction.name(), fefunction.scalar_factor)
+      explicit Coefficient(const Function& function_)
+        : Coefficient(function_, internal::new_coefficient_id())
       {
       }
 
@@ -714,54 +1775,132 @@ namespace dealii
       auto
       value(const FEDatas& phi, unsigned int q) const
       {
-        return Base::scalar_factor * phi.template get_hessian<Base::index>(q);
+        using QuadraturePointType = std::decay_t<decltype(phi.get_quadrature_point(q))>;
+        if constexpr(std::is_same<QuadraturePointType, PointType>::value)
+        {
+          if (const auto* values = phi.get_coefficient_values(id))
+          {
+            value_type value;
+            internal::from_components(values + q * n_components, value);
+            return value;
+          }
+          return value_type(function(phi.get_quadrature_point(q)));
+        }
+        else
+          return function(phi.get_quadrature_point(q));
+      }
+
+      /**
+       * Evaluate the function in the quadrature point @p q of the cell batch @p phi is
+       * reinitialized on and write the n_components entries of the value to @p data.
+       */
+      template <class FEDatas>
+      void
+      evaluate_components(const FEDatas& phi, const unsigned int q,
+                          ::dealii::VectorizedArray<Number>* data) const
+      {
+        internal::to_components(value_type(function(phi.get_quadrature_point(q))), data);
+      }
+
+      // the id shared by all copies of this Coefficient, see FEDatas::get_coefficient_values()
+      unsigned int
+      get_id() const
+      {
+        return id;
       }
 
+      // the quadrature points are part of the mapping data, nothing needs to be evaluated
       template <class FEEvaluation>
       static void
-      set_evaluation_flags(FEEvaluation& phi)
+      set_evaluation_flags(FEEvaluation& /*phi*/)
       {
-        static_assert((FEEvaluation::template rank<Base::index>() > 0) ==
-                        (Base::TensorTraits::rank > 2),
-                      "Either the proposed FiniteElement is scalar valued "
-                      "and the FEHessian is vector valued or "
-                      "the FEHessian is scalar valued and "
-                      "the FiniteElement is vector valued!");
-        phi.template set_evaluation_flags<Base::index>(false, false, true);
       }
+
+      template <typename OtherNumber>
+      typename std::enable_if_t<std::is_arithmetic<OtherNumber>::value,
+                                ScaledFEFunction<Coefficient>>
+      operator*(const OtherNumber scalar_factor_) const
+      {
+        return ScaledFEFunction<Coefficient>(*this, scalar_factor_);
+      }
+
+      NegatedFEFunction<Coefficient>
+      operator-() const
+      {
+        return NegatedFEFunction<Coefficient>(*this);
+      }
+
+    private:
+      Coefficient(const Function& function_, const unsigned int id_)
+        : function(function_)
+        , id(id_)
+      {
+        static_assert(rank >= 0, "The rank of a Coefficient cannot be negative!");
+      }
+
+      const Function function;
+      const unsigned int id;
     };
 
-    template <int rank, int dim, unsigned int idx>
-    FEGradient<rank + 1, dim, idx>
-    grad(const FEFunction<rank, dim, idx>& f)
+    /**
+     * The Coefficient of rank @p rank given by @p function, e.g.
+     * make_coefficient<0, dim>([](const auto& p) { return 1. + p.square(); }).
+     */
+    template <int rank, int dim, typename Number = double, class Function>
+    Coefficient<rank, dim, Function, Number>
+    make_coefficient(const Function& function)
     {
-      return FEGradient<rank + 1, dim, idx>(f);
+      return Coefficient<rank, dim, Function, Number>(function);
     }
 
+    /**
+     * The parameter with index @p idx, constant on each cell, e.g. a material coefficient or the
+     * penalty factor of an interior penalty method. Its values are given per cell by
+     * MatrixFreeIntegratorBase::set_cell_parameter() and read as a single VectorizedArray per
+     * cell batch. On interior faces, the larger value of the two adjacent cells is used. Like
+     * for Coefficient, @p rank is the rank of the FEFunction objects it scales.
+     */
     template <int rank, int dim, unsigned int idx>
-    FEDivergence<rank - 1, dim, idx>
-    div(const FEFunction<rank, dim, idx>& f)
+    class CellParameter final
     {
-      return FEDivergence<rank - 1, dim, idx>(f);
-    }
+    public:
+      using TensorTraits = Traits::Tensor<rank, dim>;
+      static constexpr unsigned int index = idx;
 
-    template <int rank, int dim, unsigned int idx>
-    FEHessian<rank + 1, dim, idx>
-    grad(const FEGradient<rank, dim, idx>& f)
-    {
-      return FEHessian<rank + 1, dim, idx>(f);
-    }
+      CellParameter() = default;
 
-    template <int rank, int dim, unsigned int idx>
-    FELaplacian<rank - 1, dim, idx>
-    div(const FEGradient<rank, dim, idx>& f)
-    {
-      return FELaplacian<rank - 1, dim, idx>(f);
-    }
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int /*q*/) const
+      {
+        return phi.template get_cell_parameter<idx>();
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& /*phi*/)
+      {
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value,
+                                ScaledFEFunction<CellParameter>>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction<CellParameter>(*this, scalar_factor_);
+      }
+
+      NegatedFEFunction<CellParameter>
+      operator-() const
+      {
+        return NegatedFEFunction<CellParameter>(*this);
+      }
+    };
 
     template <typename Number, class A>
     typename std::enable_if_t<
-      CFL::Traits::is_fe_function_set<A>::value && std::is_arithmetic<Number>::value, A>
+      CFL::Traits::is_fe_function_set<A>::value && std::is_arithmetic<Number>::value,
+      internal::scaled_t<A>>
     operator*(const Number scalar_factor, const A& a)
     {
       return a * scalar_factor;
@@ -798,7 +1937,7 @@ namespace dealii
       }
 
       template <class NewFEFunction>
-      SumFEFunctions<NewFEFunction, FEFunction>
+      SumFEFunctions<internal::negated_t<NewFEFunction>, FEFunction>
       operator-(const NewFEFunction& new_summand) const
       {
         return operator+(-new_summand);
@@ -818,6 +1957,21 @@ namespace dealii
         FEFunction::set_evaluation_flags(phi);
       }
 
+      SumFEFunctions<internal::negated_t<FEFunction>>
+      operator-() const
+      {
+        return SumFEFunctions<internal::negated_t<FEFunction>>(-summand);
+      }
+
+      // scale each summand, such that every monomial keeps a single scalar factor
+      template <typename Number>
+      typename std::enable_if<std::is_arithmetic<Number>::value,
+                              SumFEFunctions<internal::scaled_t<FEFunction>>>::type
+      operator*(const Number scalar_factor) const
+      {
+        return SumFEFunctions<internal::scaled_t<FEFunction>>(summand * scalar_factor);
+      }
+
       const FEFunction&
       get_summand() const
       {
@@ -835,14 +1989,24 @@ namespace dealii
       using TensorTraits =
         Traits::Tensor<FEFunction::TensorTraits::rank, FEFunction::TensorTraits::dim>;
 
+      // negated summands are subtracted instead of added
       template <class FEEvaluation>
       auto
       value(const FEEvaluation& phi, unsigned int q) const
       {
-        const auto own_value = summand.value(phi, q);
         const auto other_value = SumFEFunctions<Types...>::value(phi, q);
-        assert_is_compatible(own_value, other_value);
-        return own_value + other_value;
+        if constexpr(internal::is_negated<FEFunction>::value)
+        {
+          const auto own_value = summand.get_unscaled().value(phi, q);
+          assert_is_compatible(own_value, other_value);
+          return other_value - own_value;
+        }
+        else
+        {
+          const auto own_value = summand.value(phi, q);
+          assert_is_compatible(own_value, other_value);
+          return own_value + other_value;
+        }
       }
 
       template <class FEEvaluation>
@@ -905,30 +2069,51 @@ namespace dealii
       }
 
       template <class NewFEFunction>
-      typename std::enable_if<CFL::Traits::is_fe_function_set<NewFEFunction>::value,
-                              SumFEFunctions<NewFEFunction, FEFunction, Types...>>::type
+      typename std::enable_if<
+        CFL::Traits::is_fe_function_set<NewFEFunction>::value,
+        SumFEFunctions<internal::negated_t<NewFEFunction>, FEFunction, Types...>>::type
       operator-(const NewFEFunction& new_summand) const
       {
         return operator+(-new_summand);
       }
 
       template <class NewFEFunction, typename... NewTypes>
-      typename std::enable_if<
-        CFL::Traits::is_fe_function_set<NewFEFunction>::value,
-        SumFEFunctions<NewTypes..., NewFEFunction, FEFunction, Types...>>::type
+      typename std::enable_if<CFL::Traits::is_fe_function_set<NewFEFunction>::value,
+                              SumFEFunctions<internal::negated_t<NewTypes>...,
+                                             internal::negated_t<NewFEFunction>, FEFunction,
+                                             Types...>>::type
       operator-(const SumFEFunctions<NewFEFunction, NewTypes...>& new_sum) const
       {
         return operator+(-new_sum);
       }
 
       template <class NewFEFunction>
-      typename std::enable_if<CFL::Traits::is_fe_function_set<NewFEFunction>::value,
-                              SumFEFunctions<NewFEFunction, FEFunction, Types...>>::type
+      typename std::enable_if<
+        CFL::Traits::is_fe_function_set<NewFEFunction>::value,
+        SumFEFunctions<internal::negated_t<NewFEFunction>, FEFunction, Types...>>::type
       operator-(const SumFEFunctions<NewFEFunction>& new_sum) const
       {
         return operator+(-new_sum);
       }
 
+      SumFEFunctions<internal::negated_t<FEFunction>, internal::negated_t<Types>...>
+      operator-() const
+      {
+        return SumFEFunctions<internal::negated_t<FEFunction>, internal::negated_t<Types>...>(
+          -summand, -static_cast<const SumFEFunctions<Types...>&>(*this));
+      }
+
+      template <typename Number>
+      typename std::enable_if<
+        std::is_arithmetic<Number>::value,
+        SumFEFunctions<internal::scaled_t<FEFunction>, internal::scaled_t<Types>...>>::type
+      operator*(const Number scalar_factor) const
+      {
+        return SumFEFunctions<internal::scaled_t<FEFunction>, internal::scaled_t<Types>...>(
+          summand * scalar_factor,
+          static_cast<const SumFEFunctions<Types...>&>(*this) * scalar_factor);
+      }
+
       const FEFunction&
       get_summand() const
       {
@@ -964,7 +2149,7 @@ namespace dealii
     template <class FEFunction1, class FEFunction2>
     typename std::enable_if<Traits::is_fe_function_set<FEFunction1>::value &&
                               Traits::is_fe_function_set<FEFunction2>::value,
-                            SumFEFunctions<FEFunction2, FEFunction1>>::type
+                            SumFEFunctions<internal::negated_t<FEFunction2>, FEFunction1>>::type
     operator-(const FEFunction1& old_fe_function, const FEFunction2& new_fe_function)
     {
       return old_fe_function + (-new_fe_function);
@@ -972,12 +2157,16 @@ namespace dealii
 
     template <class FEFunction, typename... Types>
     typename std::enable_if<Traits::is_fe_function_set<FEFunction>::value,
-                            SumFEFunctions<FEFunction, Types...>>::type
+                            SumFEFunctions<FEFunction, internal::negated_t<Types>...>>::type
     operator-(const FEFunction& new_fe_function, const SumFEFunctions<Types...>& old_fe_function)
     {
       return -(old_fe_function - new_fe_function);
     }
 
+    /**
+     * The factors of a product have no scalar factor, see NegatedFEFunction and
+     * ScaledFEFunction: the product of their values is the value of the product.
+     */
     template <class FEFunction>
     class ProductFEFunctions<FEFunction>
     {
@@ -985,15 +2174,20 @@ namespace dealii
       using TensorTraits =
         Traits::Tensor<FEFunction::TensorTraits::rank, FEFunction::TensorTraits::dim>;
 
-      explicit ProductFEFunctions(const FEFunction factor_)
-        : factor(std::move(factor_))
+      explicit ProductFEFunctions(const FEFunction& factor_)
+        : factor(factor_)
       {
         static_assert(Traits::is_fe_function_set<FEFunction>::value,
                       "You need to construct this with a FEFunction object!");
+        static_assert(!internal::has_scalar_factor<FEFunction>::value,
+                      "The scalar factors are kept outside of the product!");
       }
 
       template <class NewFEFunction>
-      ProductFEFunctions<NewFEFunction, FEFunction> operator*(const NewFEFunction& new_factor) const
+      typename std::enable_if<CFL::Traits::is_fe_function_set<NewFEFunction>::value &&
+                                !internal::has_scalar_factor<NewFEFunction>::value,
+                              ProductFEFunctions<NewFEFunction, FEFunction>>::type
+      operator*(const NewFEFunction& new_factor) const
       {
         static_assert(Traits::is_fe_function_set<NewFEFunction>::value,
                       "Only FEFunction objects can be added!");
@@ -1001,7 +2195,15 @@ namespace dealii
                       "You can only add tensors of equal dimension!");
         static_assert(TensorTraits::rank == NewFEFunction::TensorTraits::rank,
                       "You can only add tensors of equal rank!");
-        return ProductFEFunctions<NewFEFunction, FEFunction>(new_factor, factor);
+        return ProductFEFunctions<NewFEFunction, FEFunction>(new_factor, *this);
+      }
+
+      template <typename Number>
+      typename std::enable_if<std::is_arithmetic<Number>::value,
+                              ScaledFEFunction<ProductFEFunctions<FEFunction>>>::type
+      operator*(const Number scalar_factor) const
+      {
+        return ScaledFEFunction<ProductFEFunctions<FEFunction>>(*this, scalar_factor);
       }
 
       template <class FEEvaluation>
@@ -1018,6 +2220,12 @@ namespace dealii
         FEFunction::set_evaluation_flags(phi);
       }
 
+      NegatedFEFunction<ProductFEFunctions<FEFunction>>
+      operator-() const
+      {
+        return NegatedFEFunction<ProductFEFunctions<FEFunction>>(*this);
+      }
+
       const FEFunction&
       get_factor() const
       {
@@ -1059,6 +2267,8 @@ namespace dealii
       {
         static_assert(Traits::is_fe_function_set<FEFunction>::value,
                       "You need to construct this with a FEFunction object!");
+        static_assert(!internal::has_scalar_factor<FEFunction>::value,
+                      "The scalar factors are kept outside of the product!");
         static_assert(TensorTraits::dim == ProductFEFunctions<Types...>::TensorTraits::dim,
                       "You can only add tensors of equal dimension!");
         static_assert(TensorTraits::rank == ProductFEFunctions<Types...>::TensorTraits::rank,
@@ -1071,6 +2281,8 @@ namespace dealii
       {
         static_assert(Traits::is_fe_function_set<FEFunction>::value,
                       "You need to construct this with a FEFunction object!");
+        static_assert(!internal::has_scalar_factor<FEFunction>::value,
+                      "The scalar factors are kept outside of the product!");
         static_assert(TensorTraits::dim == ProductFEFunctions<Types...>::TensorTraits::dim,
                       "You can only add tensors of equal dimension!");
         static_assert(TensorTraits::rank == ProductFEFunctions<Types...>::TensorTraits::rank,
@@ -1078,7 +2290,8 @@ namespace dealii
       }
 
       template <class NewFEFunction>
-      typename std::enable_if<CFL::Traits::is_fe_function_set<NewFEFunction>::value,
+      typename std::enable_if<CFL::Traits::is_fe_function_set<NewFEFunction>::value &&
+                                !internal::has_scalar_factor<NewFEFunction>::value,
                               ProductFEFunctions<NewFEFunction, FEFunction, Types...>>::type
       operator*(const NewFEFunction& new_factor) const
       {
@@ -1087,19 +2300,10 @@ namespace dealii
 
       template <typename Number>
       typename std::enable_if<std::is_arithmetic<Number>::value,
-                              ProductFEFunctions<FEFunction, Types...>>::type
+                              ScaledFEFunction<ProductFEFunctions<FEFunction, Types...>>>::type
       operator*(const Number scalar_factor) const
       {
-        ProductFEFunctions<FEFunction, Types...> tmp = *this;
-        tmp.multiply_by_scalar(scalar_factor);
-        return tmp;
-      }
-
-      template <typename Number>
-      std::enable_if_t<std::is_arithmetic<Number>::value>
-      multiply_by_scalar(const Number scalar)
-      {
-        factor.scalar_factor *= scalar;
+        return ScaledFEFunction<ProductFEFunctions<FEFunction, Types...>>(*this, scalar_factor);
       }
 
       template <class NewFEFunction, typename... NewTypes>
@@ -1123,6 +2327,12 @@ namespace dealii
                                                                        *this);
       }
 
+      NegatedFEFunction<ProductFEFunctions<FEFunction, Types...>>
+      operator-() const
+      {
+        return NegatedFEFunction<ProductFEFunctions<FEFunction, Types...>>(*this);
+      }
+
       const FEFunction&
       get_factor() const
       {
@@ -1130,14 +2340,16 @@ namespace dealii
       }
 
     private:
-      FEFunction factor;
+      const FEFunction factor;
     };
 
     template <class FEFunction1, class FEFunction2>
     typename std::enable_if<Traits::is_fe_function_set<FEFunction1>::value &&
                               !Traits::is_fe_function_product<FEFunction1>::value &&
+                              !internal::has_scalar_factor<FEFunction1>::value &&
                               Traits::is_fe_function_set<FEFunction2>::value &&
-                              !Traits::is_fe_function_product<FEFunction2>::value,
+                              !Traits::is_fe_function_product<FEFunction2>::value &&
+                              !internal::has_scalar_factor<FEFunction2>::value,
                             ProductFEFunctions<FEFunction2, FEFunction1>>::type
     operator*(const FEFunction1& old_fe_function, const FEFunction2& new_fe_function)
     {
@@ -1149,13 +2361,54 @@ namespace dealii
     }
 
     template <class FEFunction, typename... Types>
-    typename std::enable_if<Traits::is_fe_function_set<FEFunction>::value,
+    typename std::enable_if<Traits::is_fe_function_set<FEFunction>::value &&
+                              !internal::has_scalar_factor<FEFunction>::value,
                             ProductFEFunctions<FEFunction, Types...>>::type
     operator*(const FEFunction& new_fe_function,
               const ProductFEFunctions<Types...>& old_fe_function)
     {
       return old_fe_function * new_fe_function;
     }
+
+    namespace internal
+    {
+      // the product of @p a and @p b with their scalar factors moved outwards
+      template <class FEFunction1, class FEFunction2>
+      auto
+      multiply_scaled(const FEFunction1& a, const FEFunction2& b)
+      {
+        const auto product = unscaled(a) * unscaled(b);
+        if constexpr(is_scaled<FEFunction1>::value || is_scaled<FEFunction2>::value)
+          return product * (get_scalar_factor(a) * get_scalar_factor(b));
+        else if constexpr(is_negated<FEFunction1>::value != is_negated<FEFunction2>::value)
+          return -product;
+        else
+          return product;
+      }
+
+      template <class FEFunction1, class FEFunction2>
+      struct scaled_product
+      {
+        using type = decltype(multiply_scaled(std::declval<const FEFunction1&>(),
+                                              std::declval<const FEFunction2&>()));
+      };
+    } // namespace internal
+
+    /**
+     * Products of factors with a scalar factor, e.g. 3 * u * (-e), are the product of the
+     * factors without them, times the product of the scalar factors. Signs alone stay in the
+     * type: -u * -e is u * e.
+     */
+    template <class FEFunction1, class FEFunction2>
+    typename std::enable_if_t<Traits::is_fe_function_set<FEFunction1>::value &&
+                                Traits::is_fe_function_set<FEFunction2>::value &&
+                                (internal::has_scalar_factor<FEFunction1>::value ||
+                                 internal::has_scalar_factor<FEFunction2>::value),
+                              internal::scaled_product<FEFunction1, FEFunction2>>::type
+    operator*(const FEFunction1& a, const FEFunction2& b)
+    {
+      return internal::multiply_scaled(a, b);
+    }
   } // namespace MatrixFree
 } // namespace dealii
 } // namespace CFL
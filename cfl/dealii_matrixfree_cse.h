@@ -0,0 +1,534 @@
+#ifndef cfl_dealii_matrixfree_cse_h
+#define cfl_dealii_matrixfree_cse_h
+
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/forms.h>
+#include <cfl/traits.h>
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace CFL
+{
+namespace dealii
+{
+  namespace MatrixFree
+  {
+    namespace internal
+    {
+      namespace cse
+      {
+        template <class... Types>
+        struct TypeList
+        {
+        };
+
+        template <class T, class List>
+        struct contains;
+
+        template <class T, class... Types>
+        struct contains<T, TypeList<Types...>>
+          : std::integral_constant<bool, (false || ... || std::is_same<T, Types>::value)>
+        {
+        };
+
+        template <class T, class List>
+        struct index_of;
+
+        template <class T, class... Types>
+        struct index_of<T, TypeList<T, Types...>> : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template <class T, class U, class... Types>
+        struct index_of<T, TypeList<U, Types...>>
+          : std::integral_constant<std::size_t, 1 + index_of<T, TypeList<Types...>>::value>
+        {
+        };
+
+        template <class List, class T, bool = contains<T, List>::value>
+        struct append_unique
+        {
+          using type = List;
+        };
+
+        template <class... Types, class T>
+        struct append_unique<TypeList<Types...>, T, false>
+        {
+          using type = TypeList<Types..., T>;
+        };
+
+        template <class... Lists>
+        struct concat
+        {
+          using type = TypeList<>;
+        };
+
+        template <class... Types>
+        struct concat<TypeList<Types...>>
+        {
+          using type = TypeList<Types...>;
+        };
+
+        template <class... TypesA, class... TypesB, class... Lists>
+        struct concat<TypeList<TypesA...>, TypeList<TypesB...>, Lists...>
+          : concat<TypeList<TypesA..., TypesB...>, Lists...>
+        {
+        };
+
+        template <class T>
+        using is_terminal = std::integral_constant<bool, Traits::is_fe_function_terminal<T>::value>;
+
+        // ProductFEFunctions<A> only forwards to A
+        template <class T>
+        struct normalize
+        {
+          using type = T;
+        };
+
+        template <class A>
+        struct normalize<ProductFEFunctions<A>> : normalize<A>
+        {
+        };
+
+        template <class T>
+        using normalize_t = typename normalize<T>::type;
+
+        template <class T>
+        struct is_single_factor_product : std::false_type
+        {
+        };
+
+        template <class A>
+        struct is_single_factor_product<ProductFEFunctions<A>> : std::true_type
+        {
+        };
+
+        /**
+         * Products of at least two terminals. They are split into the first factor and the
+         * product of the remaining ones, just like ProductFEFunctions::value does, such that
+         * equal tails of different products are shared as well.
+         */
+        template <class T>
+        struct is_shared_product : std::false_type
+        {
+        };
+
+        template <class A, class B, class... Rest>
+        struct is_shared_product<ProductFEFunctions<A, B, Rest...>>
+          : std::integral_constant<bool, is_terminal<A>::value && is_terminal<B>::value &&
+                                           (true && ... && is_terminal<Rest>::value)>
+        {
+          using First = A;
+          using Tail = normalize_t<ProductFEFunctions<B, Rest...>>;
+        };
+
+        template <class T>
+        struct is_sum : std::false_type
+        {
+        };
+
+        template <class... Types>
+        struct is_sum<SumFEFunctions<Types...>> : std::true_type
+        {
+        };
+
+        /**
+         * Append all subexpressions of @p T that are evaluated once and shared to @p List,
+         * each after the subexpressions it depends on. Other expressions, e.g.
+         * FELiftDivergence, are evaluated for every occurrence.
+         */
+        template <class List, class T, class Enable = void>
+        struct add_nodes
+        {
+          using type = List;
+        };
+
+        template <class List, class T>
+        struct add_nodes<List, T, std::enable_if_t<is_terminal<T>::value>>
+          : append_unique<List, T>
+        {
+        };
+
+        template <class List, class A>
+        struct add_nodes<List, ProductFEFunctions<A>> : add_nodes<List, A>
+        {
+        };
+
+        // the scalar factor is applied to each occurrence, the expression itself is shared
+        template <class List, class T>
+        struct add_nodes<List, T, std::enable_if_t<has_scalar_factor<T>::value>>
+          : add_nodes<List, unscaled_t<T>>
+        {
+        };
+
+        template <class List, class T>
+        struct add_nodes<List, T, std::enable_if_t<is_shared_product<T>::value>>
+          : append_unique<typename add_nodes<
+                            typename add_nodes<List, typename is_shared_product<T>::First>::type,
+                            typename is_shared_product<T>::Tail>::type,
+                          T>
+        {
+        };
+
+        template <class List>
+        struct add_nodes<List, SumFEFunctions<>>
+        {
+          using type = List;
+        };
+
+        template <class List, class Summand, class... Summands>
+        struct add_nodes<List, SumFEFunctions<Summand, Summands...>>
+          : add_nodes<typename add_nodes<List, Summand>::type, SumFEFunctions<Summands...>>
+        {
+        };
+
+        // the number of shared subexpressions evaluated for @p T without elimination
+        template <class T, class Enable = void>
+        struct n_evaluations : std::integral_constant<unsigned int, 0>
+        {
+        };
+
+        template <class T>
+        struct n_evaluations<T, std::enable_if_t<is_terminal<T>::value>>
+          : std::integral_constant<unsigned int, 1>
+        {
+        };
+
+        template <class A>
+        struct n_evaluations<ProductFEFunctions<A>> : n_evaluations<A>
+        {
+        };
+
+        template <class T>
+        struct n_evaluations<T, std::enable_if_t<has_scalar_factor<T>::value>>
+          : n_evaluations<unscaled_t<T>>
+        {
+        };
+
+        template <class T>
+        struct n_evaluations<T, std::enable_if_t<is_shared_product<T>::value>>
+          : std::integral_constant<unsigned int,
+                                   1 + n_evaluations<typename is_shared_product<T>::First>::value +
+                                     n_evaluations<typename is_shared_product<T>::Tail>::value>
+        {
+        };
+
+        template <class... Summands>
+        struct n_evaluations<SumFEFunctions<Summands...>>
+          : std::integral_constant<unsigned int, (0u + ... + n_evaluations<Summands>::value)>
+        {
+        };
+
+        template <class FormType>
+        using expr_t = std::decay_t<decltype(std::declval<FormType>().expr)>;
+
+        template <class FormsType>
+        struct form_list;
+
+        template <class... FormTypes>
+        struct form_list<Forms<FormTypes...>>
+        {
+          using type = TypeList<FormTypes...>;
+        };
+
+        // the shared subexpressions of all forms integrated over @p domain
+        template <IntegrationDomain domain, class FormList, class List = TypeList<>>
+        struct domain_nodes
+        {
+          using type = List;
+        };
+
+        template <IntegrationDomain domain, class FormType, class... FormTypes, class List>
+        struct domain_nodes<domain, TypeList<FormType, FormTypes...>, List>
+          : domain_nodes<domain, TypeList<FormTypes...>,
+                         std::conditional_t<FormType::integration_domain == domain,
+                                            typename add_nodes<List, expr_t<FormType>>::type,
+                                            List>>
+        {
+        };
+
+        template <class List>
+        struct terminals;
+
+        template <class... Types>
+        struct terminals<TypeList<Types...>>
+          : concat<std::conditional_t<is_terminal<Types>::value, TypeList<Types>, TypeList<>>...>
+        {
+        };
+
+        template <class List>
+        struct size;
+
+        template <class... Types>
+        struct size<TypeList<Types...>> : std::integral_constant<unsigned int, sizeof...(Types)>
+        {
+        };
+      } // namespace cse
+    }   // namespace internal
+
+    /**
+     * A Forms object whose FEFunction terminals and products of terminals are evaluated only
+     * once per quadrature point, even if they appear in several forms or as the tail of
+     * several products. For instance, in u*u*e*v + u*u*w the product u*u is computed once
+     * and reused for u*u*e. Equal subexpressions are detected from their types at compile
+     * time. Scalar factors and signs are applied to each occurrence separately, so
+     * subexpressions that only differ by them, e.g. u*u in 3*u*u and -u*u, are shared as well.
+     *
+     * Expressions other than sums and products of terminals, e.g. FELiftDivergence, are
+     * evaluated as in Forms. Sums are not shared: equal sums in several forms are added up
+     * again from their shared summands. The number of evaluations saved per quadrature point is
+     * available at compile time as n_removed_evaluations.
+     */
+    template <class FormsType>
+    class CSEForms
+    {
+      using FormList = typename internal::cse::form_list<FormsType>::type;
+
+      template <IntegrationDomain domain>
+      using Nodes = typename internal::cse::domain_nodes<domain, FormList>::type;
+
+      using Terminals = typename internal::cse::terminals<typename internal::cse::concat<
+        Nodes<IntegrationDomain::cell>, Nodes<IntegrationDomain::face>,
+        Nodes<IntegrationDomain::boundary>>::type>::type;
+
+      template <class... FormTypes>
+      static constexpr unsigned int
+      count_evaluations(internal::cse::TypeList<FormTypes...> /*unused*/)
+      {
+        return (0u + ... + internal::cse::n_evaluations<internal::cse::expr_t<FormTypes>>::value);
+      }
+
+    public:
+      static constexpr bool has_cell_forms = FormsType::has_cell_forms;
+      static constexpr bool has_face_forms = FormsType::has_face_forms;
+      static constexpr bool has_boundary_forms = FormsType::has_boundary_forms;
+      // shared subexpressions evaluated per quadrature point without and with elimination
+      static constexpr unsigned int n_evaluations = count_evaluations(FormList());
+      static constexpr unsigned int n_removed_evaluations =
+        n_evaluations - internal::cse::size<Nodes<IntegrationDomain::cell>>::value -
+        internal::cse::size<Nodes<IntegrationDomain::face>>::value -
+        internal::cse::size<Nodes<IntegrationDomain::boundary>>::value;
+
+      explicit CSEForms(const FormsType& forms_)
+        : forms(forms_)
+        , units(make_units(Terminals()))
+      {
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_integration_flags(FEEvaluation& phi)
+      {
+        FormsType::set_integration_flags(phi);
+      }
+
+      template <class FEEvaluation>
+      void
+      set_evaluation_flags(FEEvaluation& phi) const
+      {
+        forms.set_evaluation_flags(phi);
+      }
+
+      template <class FEEvaluation>
+      static void
+      integrate(FEEvaluation& phi)
+      {
+        FormsType::integrate(phi);
+      }
+
+      template <class FEEvaluation>
+      void
+      evaluate(FEEvaluation& phi, unsigned int q) const
+      {
+        using DomainNodes = Nodes<Traits::integration_domain<FEEvaluation>::value>;
+        const auto cache = evaluate_nodes<DomainNodes>(phi, q, std::tuple<>(), DomainNodes());
+        evaluate_forms<DomainNodes>(forms, phi, q, cache, SubmittedTests<>());
+      }
+
+      const FormsType&
+      get_forms() const
+      {
+        return forms;
+      }
+
+    private:
+      const FormsType forms;
+      // a copy of each terminal, evaluated for all of its occurrences
+      template <class List>
+      struct UnitTuple;
+
+      template <class... Types>
+      struct UnitTuple<internal::cse::TypeList<Types...>>
+      {
+        using type = std::tuple<Types...>;
+      };
+
+      const typename UnitTuple<Terminals>::type units;
+
+      template <class... Types>
+      static std::tuple<Types...>
+      make_units(internal::cse::TypeList<Types...> /*unused*/)
+      {
+        return std::tuple<Types...>(Types(std::string())...);
+      }
+
+      template <class List, class T>
+      static constexpr std::size_t index = internal::cse::index_of<T, List>::value;
+
+      /**
+       * Append the values of @p Node and all following nodes to @p cache. Each node only
+       * depends on nodes before it.
+       */
+      template <class DomainNodes, class FEEvaluation, class Cache, class... Remaining>
+      auto
+      evaluate_nodes(const FEEvaluation& phi, unsigned int q, const Cache& cache,
+                     internal::cse::TypeList<Remaining...> /*unused*/) const
+      {
+        if constexpr(sizeof...(Remaining) == 0)
+        {
+          (void)phi;
+          (void)q;
+          return cache;
+        }
+        else
+          return evaluate_remaining_nodes<DomainNodes>(
+            phi, q, cache, internal::cse::TypeList<Remaining...>());
+      }
+
+      template <class DomainNodes, class FEEvaluation, class Cache, class Node, class... Remaining>
+      auto
+      evaluate_remaining_nodes(const FEEvaluation& phi, unsigned int q, const Cache& cache,
+                               internal::cse::TypeList<Node, Remaining...> /*unused*/) const
+      {
+        const auto value = [&]() {
+          if constexpr(internal::cse::is_terminal<Node>::value)
+            return std::get<index<Terminals, Node>>(units).value(phi, q);
+          else
+          {
+            using Product = internal::cse::is_shared_product<Node>;
+            return std::get<index<DomainNodes, typename Product::First>>(cache) *
+                   std::get<index<DomainNodes, typename Product::Tail>>(cache);
+          }
+        }();
+        return evaluate_nodes<DomainNodes>(phi,
+                                           q,
+                                           std::tuple_cat(cache, std::make_tuple(value)),
+                                           internal::cse::TypeList<Remaining...>());
+      }
+
+      // the value of @p expr, assembled from the shared subexpressions in @p cache
+      template <class DomainNodes, class Expr, class FEEvaluation, class Cache>
+      static auto
+      value(const Expr& expr, const FEEvaluation& phi, unsigned int q, const Cache& cache)
+      {
+        if constexpr(internal::cse::is_terminal<Expr>::value ||
+                     internal::cse::is_shared_product<Expr>::value)
+          return std::get<index<DomainNodes, Expr>>(cache);
+        else if constexpr(internal::is_negated<Expr>::value)
+          return -value<DomainNodes>(expr.get_unscaled(), phi, q, cache);
+        else if constexpr(internal::is_scaled<Expr>::value)
+          return expr.scalar_factor * value<DomainNodes>(expr.get_unscaled(), phi, q, cache);
+        else if constexpr(internal::cse::is_single_factor_product<Expr>::value)
+          return value<DomainNodes>(expr.get_factor(), phi, q, cache);
+        else if constexpr(internal::cse::is_sum<Expr>::value)
+          return sum_value<DomainNodes>(expr, phi, q, cache);
+        else
+          return expr.value(phi, q);
+      }
+
+      // negated summands are subtracted, like in SumFEFunctions::value
+      template <class DomainNodes, class FEEvaluation, class Cache, class Summand,
+                class... Summands>
+      static auto
+      sum_value(const SumFEFunctions<Summand, Summands...>& sum, const FEEvaluation& phi,
+                unsigned int q, const Cache& cache)
+      {
+        if constexpr(sizeof...(Summands) == 0)
+          return value<DomainNodes>(sum.get_summand(), phi, q, cache);
+        else
+        {
+          const auto other_value = sum_value<DomainNodes>(
+            static_cast<const SumFEFunctions<Summands...>&>(sum), phi, q, cache);
+          if constexpr(internal::is_negated<Summand>::value)
+            return other_value -
+                   value<DomainNodes>(sum.get_summand().get_unscaled(), phi, q, cache);
+          else
+            return value<DomainNodes>(sum.get_summand(), phi, q, cache) + other_value;
+        }
+      }
+
+      // the sum of the values of all forms tested by @p Test, see Forms::tested_value
+      template <class DomainNodes, class Test, class FEEvaluation, class Cache, class FormType,
+                class... FormTypes>
+      static auto
+      tested_value(const Forms<FormType, FormTypes...>& forms_, const FEEvaluation& phi,
+                   unsigned int q, const Cache& cache)
+      {
+        constexpr bool is_tested = std::is_same<Test, typename FormType::TestType>::value;
+        constexpr bool rest_is_tested = Traits::is_tested_by<Test, FormTypes...>::value;
+        if constexpr(is_tested && rest_is_tested)
+          return value<DomainNodes>(forms_.get_form().expr, phi, q, cache) +
+                 tested_value<DomainNodes, Test>(
+                   static_cast<const Forms<FormTypes...>&>(forms_), phi, q, cache);
+        else if constexpr(is_tested)
+          return value<DomainNodes>(forms_.get_form().expr, phi, q, cache);
+        else
+          return tested_value<DomainNodes, Test>(
+            static_cast<const Forms<FormTypes...>&>(forms_), phi, q, cache);
+      }
+
+      // like Forms::evaluate, all values are computed before anything is submitted, forms
+      // sharing a test function are submitted once and forms sharing a SubmissionSlot add up
+      template <class DomainNodes, class FEEvaluation, class Cache, class FormType,
+                class... FormTypes, class... Tests>
+      static void
+      evaluate_forms(const Forms<FormType, FormTypes...>& forms_, FEEvaluation& phi,
+                     unsigned int q, const Cache& cache, SubmittedTests<Tests...> submitted)
+      {
+        using Test = typename FormType::TestType;
+        constexpr bool submits = FormType::template is_evaluated_by<FEEvaluation>() &&
+                                 !Traits::is_one_of<Test, Tests...>::value;
+        if constexpr(submits)
+        {
+          const auto form_value = tested_value<DomainNodes, Test>(forms_, phi, q, cache);
+          if constexpr(sizeof...(FormTypes) > 0)
+            evaluate_forms<DomainNodes>(static_cast<const Forms<FormTypes...>&>(forms_),
+                                        phi,
+                                        q,
+                                        cache,
+                                        SubmittedTests<Tests..., Test>());
+          if constexpr(Traits::shares_submission_slot<Test, FEEvaluation,
+                                                      SubmittedTests<Tests...>,
+                                                      FormTypes...>::value)
+            FormType::submit_add(phi, q, form_value);
+          else
+            FormType::submit(phi, q, form_value);
+        }
+        else if constexpr(sizeof...(FormTypes) > 0)
+          evaluate_forms<DomainNodes>(
+            static_cast<const Forms<FormTypes...>&>(forms_), phi, q, cache, submitted);
+      }
+    };
+
+    /**
+     * Wrap @p forms, a Form or Forms object, such that common subexpressions are evaluated
+     * only once per quadrature point, see CSEForms. The result can be used by a
+     * MatrixFreeIntegrator like the original forms.
+     */
+    template <class FormsType>
+    auto
+    eliminate_common_subexpressions(const FormsType& forms)
+    {
+      if constexpr(Traits::is_form<FormsType>::value)
+        return CSEForms<Forms<FormsType>>(Forms<FormsType>(forms));
+      else
+        return CSEForms<FormsType>(forms);
+    }
+  } // namespace MatrixFree
+} // namespace dealii
+} // namespace CFL
+
+#endif // cfl_dealii_matrixfree_cse_h
@@ -0,0 +1,589 @@
+#ifndef cfl_dealii_matrixfree_functions_h
+#define cfl_dealii_matrixfree_functions_h
+
+#include <deal.II/base/vectorization.h>
+
+#include <cfl/dealii_matrixfree.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace CFL
+{
+namespace dealii
+{
+  namespace MatrixFree
+  {
+    /**
+     * The accuracy of the vectorized functions below. The polynomial approximations are
+     * truncated after as many terms as needed for a relative error of about 1e-7 (low, enough
+     * for float), 1e-11 (medium) or double precision (high) on the reduced argument.
+     */
+    enum class Accuracy
+    {
+      low,
+      medium,
+      high
+    };
+
+    /**
+     * Elementary functions on all lanes of a VectorizedArray at once. After a range reduction,
+     * which is the only part working lane by lane on the bit representation, they are
+     * evaluated as polynomials with VectorizedArray arithmetic instead of calling the scalar
+     * libm function for each lane.
+     */
+    namespace simd
+    {
+      template <typename Number>
+      struct Constants;
+
+      template <>
+      struct Constants<double>
+      {
+        using Bits = std::uint64_t;
+        static constexpr unsigned int mantissa_bits = 52;
+        static constexpr int bias = 1023;
+        // adding and subtracting 1.5*2^52 rounds to the nearest integer
+        static constexpr double shifter = 6755399441055744.;
+        // exp(x) is infinite above and zero below, see exp()
+        static constexpr double max_exp_argument = 746.;
+        // ln(2) and pi/2 split such that multiples of the leading parts are exact
+        static constexpr double ln2_hi = 6.93147180369123816490e-01;
+        static constexpr double ln2_lo = 1.90821492927058770002e-10;
+        static constexpr double pio2_1 = 1.57079632673412561417e+00;
+        static constexpr double pio2_2 = 6.07710050630396597660e-11;
+        static constexpr double pio2_3 = 2.02226624879595063154e-21;
+      };
+
+      template <>
+      struct Constants<float>
+      {
+        using Bits = std::uint32_t;
+        static constexpr unsigned int mantissa_bits = 23;
+        static constexpr int bias = 127;
+        static constexpr float shifter = 12582912.f;
+        static constexpr float max_exp_argument = 104.f;
+        static constexpr float ln2_hi = 0.693359375f;
+        static constexpr float ln2_lo = -2.12194440e-4f;
+        static constexpr float pio2_1 = 1.5703125f;
+        static constexpr float pio2_2 = 4.837512969970703125e-4f;
+        static constexpr float pio2_3 = 7.54978995489188216e-8f;
+      };
+
+      constexpr unsigned int
+      n_terms(const Accuracy accuracy, const unsigned int low, const unsigned int medium,
+              const unsigned int high)
+      {
+        return accuracy == Accuracy::low ? low : (accuracy == Accuracy::medium ? medium : high);
+      }
+
+      constexpr double
+      factorial(const unsigned int i)
+      {
+        return i < 2 ? 1. : i * factorial(i - 1);
+      }
+
+      // the coefficients coefficient(0), ..., coefficient(n-1) of a series
+      template <unsigned int n, class Coefficient>
+      constexpr std::array<double, n>
+      tabulate(const Coefficient& coefficient)
+      {
+        std::array<double, n> coefficients{};
+        for (unsigned int i = 0; i < n; ++i)
+          coefficients[i] = coefficient(i);
+        return coefficients;
+      }
+
+      // c[0] + c[1] x + ... + c[n-1] x^(n-1) by the Horner scheme
+      template <typename Number, std::size_t n>
+      ::dealii::VectorizedArray<Number>
+      horner(const ::dealii::VectorizedArray<Number>& x, const std::array<double, n>& c)
+      {
+        ::dealii::VectorizedArray<Number> result = x * Number(c[n - 1]) + Number(c[n - 2]);
+        for (std::size_t i = n - 2; i-- > 0;)
+          result = result * x + Number(c[i]);
+        return result;
+      }
+
+      // round to the nearest integer, valid for |x| < 2^51 (2^22 for float)
+      template <typename Number>
+      ::dealii::VectorizedArray<Number>
+      round(const ::dealii::VectorizedArray<Number>& x)
+      {
+        return (x + Constants<Number>::shifter) - Constants<Number>::shifter;
+      }
+
+      // 2^k for integers k in the range of normal numbers, set directly in the exponent bits
+      template <typename Number>
+      Number
+      exp2_integer(const int k)
+      {
+        using Bits = typename Constants<Number>::Bits;
+        const Bits bits = static_cast<Bits>(k + Constants<Number>::bias)
+                          << Constants<Number>::mantissa_bits;
+        Number result;
+        std::memcpy(&result, &bits, sizeof(Number));
+        return result;
+      }
+
+      /**
+       * x 2^k for integers k up to about twice the exponent range. 2^k is applied in two
+       * factors in the range of normal numbers, such that the result overflows to infinity or
+       * underflows to subnormal numbers and zero like the exact value would.
+       */
+      template <typename Number>
+      ::dealii::VectorizedArray<Number>
+      scale_exp2(const ::dealii::VectorizedArray<Number>& x,
+                 const ::dealii::VectorizedArray<Number>& k)
+      {
+        ::dealii::VectorizedArray<Number> result;
+        for (unsigned int l = 0; l < ::dealii::VectorizedArray<Number>::n_array_elements; ++l)
+        {
+          const int k_1 = static_cast<int>(k[l]) / 2;
+          const int k_2 = static_cast<int>(k[l]) - k_1;
+          result[l] = exp2_integer<Number>(k_1) * (x[l] * exp2_integer<Number>(k_2));
+        }
+        return result;
+      }
+
+      // split positive and finite x into x = m 2^e with sqrt(1/2) <= m < sqrt(2)
+      template <typename Number>
+      void
+      split_exponent(const ::dealii::VectorizedArray<Number>& x,
+                     ::dealii::VectorizedArray<Number>& m, ::dealii::VectorizedArray<Number>& e)
+      {
+        using Bits = typename Constants<Number>::Bits;
+        constexpr unsigned int mantissa_bits = Constants<Number>::mantissa_bits;
+        constexpr int bias = Constants<Number>::bias;
+        constexpr Bits mantissa_mask = (Bits(1) << mantissa_bits) - 1;
+        for (unsigned int l = 0; l < ::dealii::VectorizedArray<Number>::n_array_elements; ++l)
+        {
+          // subnormal numbers are scaled into the normal range first
+          const bool is_subnormal = x[l] < std::numeric_limits<Number>::min();
+          const Number x_l =
+            is_subnormal ? x[l] * static_cast<Number>(Bits(1) << mantissa_bits) : x[l];
+          Bits bits;
+          std::memcpy(&bits, &x_l, sizeof(Number));
+          int exponent = static_cast<int>((bits >> mantissa_bits) & (2 * bias + 1)) - bias -
+                         (is_subnormal ? static_cast<int>(mantissa_bits) : 0);
+          bits = (bits & mantissa_mask) | (Bits(bias) << mantissa_bits);
+          Number mantissa;
+          std::memcpy(&mantissa, &bits, sizeof(Number));
+          if (mantissa > Number(1.41421356237309504880))
+          {
+            mantissa *= Number(0.5);
+            ++exponent;
+          }
+          m[l] = mantissa;
+          e[l] = exponent;
+        }
+      }
+
+      /**
+       * Reduce x to x = k ln(2) + r with integer k and |r| <= ln(2)/2 and return
+       * exp(r) - 1, evaluated without cancellation for small r.
+       */
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      expm1_reduced(const ::dealii::VectorizedArray<Number>& x,
+                    ::dealii::VectorizedArray<Number>& k)
+      {
+        constexpr unsigned int n = n_terms(accuracy, 6, 9, 13);
+        static constexpr auto c = tabulate<n>([](unsigned int i) { return 1. / factorial(i + 1); });
+        k = round(x * Number(1.44269504088896340736));
+        const auto r = (x - k * Constants<Number>::ln2_hi) - k * Constants<Number>::ln2_lo;
+        return r * horner(r, c);
+      }
+
+      /**
+       * exp(x), which overflows to infinity and underflows to subnormal numbers and zero like
+       * std::exp. Beyond +-max_exp_argument the result is infinite or zero anyway, so x is
+       * clamped to that range before the reduction. NaN is passed through.
+       */
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      exp(const ::dealii::VectorizedArray<Number>& x)
+      {
+        const auto bound = ::dealii::make_vectorized_array(Constants<Number>::max_exp_argument);
+        ::dealii::VectorizedArray<Number> k;
+        const auto expm1_r = expm1_reduced<accuracy>(std::min(std::max(x, -bound), bound), k);
+        auto result = scale_exp2(expm1_r + Number(1.), k);
+        for (unsigned int l = 0; l < ::dealii::VectorizedArray<Number>::n_array_elements; ++l)
+          if (x[l] != x[l])
+            result[l] = x[l];
+        return result;
+      }
+
+      // exp(x) - 1 for |x| < 700 (80 for float), only used by tanh
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      expm1(const ::dealii::VectorizedArray<Number>& x)
+      {
+        ::dealii::VectorizedArray<Number> k;
+        const auto expm1_r = expm1_reduced<accuracy>(x, k);
+        const auto scale = scale_exp2(::dealii::make_vectorized_array(Number(1.)), k);
+        return scale * expm1_r + (scale - Number(1.));
+      }
+
+      /**
+       * The natural logarithm, log(m 2^e) = e ln(2) + 2 atanh((m-1)/(m+1)). Like std::log, it
+       * is -infinity for zero, NaN for negative numbers and NaN, and infinity for infinity.
+       */
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      log(const ::dealii::VectorizedArray<Number>& x)
+      {
+        constexpr unsigned int n = n_terms(accuracy, 4, 6, 10);
+        static constexpr auto c = tabulate<n>([](unsigned int i) { return 1. / (2 * i + 1); });
+        ::dealii::VectorizedArray<Number> m, e;
+        split_exponent(x, m, e);
+        const auto s = (m - Number(1.)) / (m + Number(1.));
+        const auto log_m = Number(2.) * s * horner(s * s, c);
+        auto result = e * Constants<Number>::ln2_hi + (log_m + e * Constants<Number>::ln2_lo);
+        for (unsigned int l = 0; l < ::dealii::VectorizedArray<Number>::n_array_elements; ++l)
+          if (x[l] == Number(0.))
+            result[l] = -std::numeric_limits<Number>::infinity();
+          else if (!(x[l] > Number(0.)))
+            result[l] = std::numeric_limits<Number>::quiet_NaN();
+          else if (x[l] == std::numeric_limits<Number>::infinity())
+            result[l] = x[l];
+        return result;
+      }
+
+      /**
+       * sin(x) and cos(x) at once. x is reduced to x = k pi/2 + r with |r| <= pi/4 and the
+       * quadrant k mod 4 selects between sin(r) and cos(r) and their signs. The reduction
+       * loses accuracy for very large |x|.
+       */
+      template <Accuracy accuracy, typename Number>
+      void
+      sin_cos(const ::dealii::VectorizedArray<Number>& x, ::dealii::VectorizedArray<Number>& sin_x,
+              ::dealii::VectorizedArray<Number>& cos_x)
+      {
+        constexpr unsigned int n_sin = n_terms(accuracy, 4, 6, 9);
+        constexpr unsigned int n_cos = n_terms(accuracy, 5, 7, 10);
+        static constexpr auto c_sin = tabulate<n_sin>(
+          [](unsigned int i) { return (i % 2 == 0 ? 1. : -1.) / factorial(2 * i + 1); });
+        static constexpr auto c_cos = tabulate<n_cos>(
+          [](unsigned int i) { return (i % 2 == 0 ? 1. : -1.) / factorial(2 * i); });
+        const auto k = round(x * Number(0.63661977236758134308));
+        const auto r = ((x - k * Constants<Number>::pio2_1) - k * Constants<Number>::pio2_2) -
+                       k * Constants<Number>::pio2_3;
+        const auto r2 = r * r;
+        const auto sin_r = r * horner(r2, c_sin);
+        const auto cos_r = horner(r2, c_cos);
+        for (unsigned int l = 0; l < ::dealii::VectorizedArray<Number>::n_array_elements; ++l)
+        {
+          const int quadrant = static_cast<int>(k[l]) & 3;
+          const Number s = (quadrant % 2 == 0) ? sin_r[l] : cos_r[l];
+          const Number c = (quadrant % 2 == 0) ? cos_r[l] : sin_r[l];
+          sin_x[l] = (quadrant >= 2) ? -s : s;
+          cos_x[l] = (quadrant == 1 || quadrant == 2) ? -c : c;
+        }
+      }
+
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      sin(const ::dealii::VectorizedArray<Number>& x)
+      {
+        ::dealii::VectorizedArray<Number> sin_x, cos_x;
+        sin_cos<accuracy>(x, sin_x, cos_x);
+        return sin_x;
+      }
+
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      cos(const ::dealii::VectorizedArray<Number>& x)
+      {
+        ::dealii::VectorizedArray<Number> sin_x, cos_x;
+        sin_cos<accuracy>(x, sin_x, cos_x);
+        return cos_x;
+      }
+
+      // tanh(x) = expm1(2x) / (expm1(2x) + 2), which is 1 in double precision for |x| > 20
+      template <Accuracy accuracy, typename Number>
+      ::dealii::VectorizedArray<Number>
+      tanh(const ::dealii::VectorizedArray<Number>& x)
+      {
+        const auto bound = ::dealii::make_vectorized_array(Number(20.));
+        const auto expm1_2x = expm1<accuracy>(Number(2.) * std::min(std::max(x, -bound), bound));
+        return expm1_2x / (expm1_2x + Number(2.));
+      }
+    } // namespace simd
+
+    /**
+     * The functions available for FEUnaryFunction. Each provides its value on a
+     * VectorizedArray and its derivative as another function times derivative_factor. The
+     * functions only appearing as derivatives have no derivative themselves.
+     */
+    namespace UnaryFunctions
+    {
+      struct Reciprocal
+      {
+        using Derivative = void;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return Number(1.) / x;
+        }
+      };
+
+      struct ReciprocalSqrt
+      {
+        using Derivative = void;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return Number(1.) / std::sqrt(x);
+        }
+      };
+
+      // 1 - tanh^2
+      struct Sech2
+      {
+        using Derivative = void;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          const auto tanh_x = simd::tanh<accuracy>(x);
+          return Number(1.) - tanh_x * tanh_x;
+        }
+      };
+
+      struct Exp
+      {
+        using Derivative = Exp;
+        static constexpr double derivative_factor = 1.;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return simd::exp<accuracy>(x);
+        }
+      };
+
+      struct Log
+      {
+        using Derivative = Reciprocal;
+        static constexpr double derivative_factor = 1.;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return simd::log<accuracy>(x);
+        }
+      };
+
+      struct Sin;
+
+      struct Cos
+      {
+        using Derivative = Sin;
+        static constexpr double derivative_factor = -1.;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return simd::cos<accuracy>(x);
+        }
+      };
+
+      struct Sin
+      {
+        using Derivative = Cos;
+        static constexpr double derivative_factor = 1.;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return simd::sin<accuracy>(x);
+        }
+      };
+
+      struct Tanh
+      {
+        using Derivative = Sech2;
+        static constexpr double derivative_factor = 1.;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return simd::tanh<accuracy>(x);
+        }
+      };
+
+      // uses the vectorized square root of VectorizedArray, which is exact for any accuracy
+      struct Sqrt
+      {
+        using Derivative = ReciprocalSqrt;
+        static constexpr double derivative_factor = 0.5;
+
+        template <Accuracy accuracy, typename Number>
+        static ::dealii::VectorizedArray<Number>
+        value(const ::dealii::VectorizedArray<Number>& x)
+        {
+          return std::sqrt(x);
+        }
+      };
+    } // namespace UnaryFunctions
+
+    /**
+     * The function @p Function of a scalar valued FEFunction object u, e.g. exp(u), evaluated
+     * on all lanes of the quadrature point data at once with the given @p accuracy. u may have
+     * a scalar factor, e.g. exp(2 * u), while scalar factors of the function value are kept by
+     * NegatedFEFunction and ScaledFEFunction. linearize uses the derivative given by
+     * @p Function.
+     */
+    template <class Function, Accuracy accuracy, class FEFunctionType>
+    class FEUnaryFunction final
+    {
+    public:
+      using TensorTraits = typename FEFunctionType::TensorTraits;
+      static constexpr unsigned int index = internal::unscaled_t<FEFunctionType>::index;
+
+      explicit FEUnaryFunction(const FEFunctionType& fe_function_)
+        : fe_function(fe_function_)
+      {
+        static_assert(
+          Traits::is_fe_function_terminal<internal::unscaled_t<FEFunctionType>>::value,
+          "Only functions of FEFunction objects are supported!");
+        static_assert(TensorTraits::rank == 0,
+                      "Only functions of scalar valued FEFunctions are supported!");
+      }
+
+      template <class FEDatas>
+      auto
+      value(const FEDatas& phi, unsigned int q) const
+      {
+        return Function::template value<accuracy>(fe_function.value(phi, q));
+      }
+
+      template <class FEEvaluation>
+      static void
+      set_evaluation_flags(FEEvaluation& phi)
+      {
+        FEFunctionType::set_evaluation_flags(phi);
+      }
+
+      template <typename Number>
+      typename std::enable_if_t<std::is_arithmetic<Number>::value,
+                                ScaledFEFunction<FEUnaryFunction>>
+      operator*(const Number scalar_factor_) const
+      {
+        return ScaledFEFunction<FEUnaryFunction>(*this, scalar_factor_);
+      }
+
+      NegatedFEFunction<FEUnaryFunction>
+      operator-() const
+      {
+        return NegatedFEFunction<FEUnaryFunction>(*this);
+      }
+
+      const FEFunctionType&
+      get_fe_function() const
+      {
+        return fe_function;
+      }
+
+      // the derivative with respect to the argument, used by linearize
+      auto
+      outer_derivative() const
+      {
+        static_assert(!std::is_void<typename Function::Derivative>::value,
+                      "The derivative of this function cannot be linearized!");
+        const FEUnaryFunction<typename Function::Derivative, accuracy, FEFunctionType> derivative(
+          fe_function);
+        if constexpr(Function::derivative_factor == 1.)
+          return derivative;
+        else if constexpr(Function::derivative_factor == -1.)
+          return -derivative;
+        else
+          return derivative * Function::derivative_factor;
+      }
+
+    private:
+      const FEFunctionType fe_function;
+    };
+
+    template <class Function, Accuracy accuracy, class FEFunctionType>
+    using enable_if_terminal_t = std::enable_if_t<
+      Traits::is_fe_function_terminal<internal::unscaled_t<FEFunctionType>>::value,
+      FEUnaryFunction<Function, accuracy, FEFunctionType>>;
+
+    template <Accuracy accuracy = Accuracy::high, class FEFunctionType>
+    enable_if_terminal_t<UnaryFunctions::Exp, accuracy, FEFunctionType>
+    exp(const FEFunctionType& f)
+    {
+      return FEUnaryFunction<UnaryFunctions::Exp, accuracy, FEFunctionType>(f);
+    }
+
+    template <Accuracy accuracy = Accuracy::high, class FEFunctionType>
+    enable_if_terminal_t<UnaryFunctions::Log, accuracy, FEFunctionType>
+    log(const FEFunctionType& f)
+    {
+      return FEUnaryFunction<UnaryFunctions::Log, accuracy, FEFunctionType>(f);
+    }
+
+    template <Accuracy accuracy = Accuracy::high, class FEFunctionType>
+    enable_if_terminal_t<UnaryFunctions::Sin, accuracy, FEFunctionType>
+    sin(const FEFunctionType& f)
+    {
+      return FEUnaryFunction<UnaryFunctions::Sin, accuracy, FEFunctionType>(f);
+    }
+
+    template <Accuracy accuracy = Accuracy::high, class FEFunctionType>
+    enable_if_terminal_t<UnaryFunctions::Cos, accuracy, FEFunctionType>
+    cos(const FEFunctionType& f)
+    {
+      return FEUnaryFunction<UnaryFunctions::Cos, accuracy, FEFunctionType>(f);
+    }
+
+    template <Accuracy accuracy = Accuracy::high, class FEFunctionType>
+    enable_if_terminal_t<UnaryFunctions::Tanh, accuracy, FEFunctionType>
+    tanh(const FEFunctionType& f)
+    {
+      return FEUnaryFunction<UnaryFunctions::Tanh, accuracy, FEFunctionType>(f);
+    }
+
+    template <Accuracy accuracy = Accuracy::high, class FEFunctionType>
+    enable_if_terminal_t<UnaryFunctions::Sqrt, accuracy, FEFunctionType>
+    sqrt(const FEFunctionType& f)
+    {
+      return FEUnaryFunction<UnaryFunctions::Sqrt, accuracy, FEFunctionType>(f);
+    }
+  } // namespace MatrixFree
+} // namespace dealii
+
+namespace Traits
+{
+  template <class Function, dealii::MatrixFree::Accuracy accuracy, class FEFunctionType>
+  struct is_cfl_object<dealii::MatrixFree::FEUnaryFunction<Function, accuracy, FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+
+  template <class Function, dealii::MatrixFree::Accuracy accuracy, class FEFunctionType>
+  struct is_fe_function_set<
+    dealii::MatrixFree::FEUnaryFunction<Function, accuracy, FEFunctionType>>
+  {
+    static const bool value = true;
+  };
+} // namespace Traits
+} // namespace CFL
+
+#endif // cfl_dealii_matrixfree_functions_h
@@ -0,0 +1,402 @@
+#ifndef cfl_dealii_matrixfree_linearize_h
+#define cfl_dealii_matrixfree_linearize_h
+
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/forms.h>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace CFL
+{
+namespace dealii
+{
+  namespace MatrixFree
+  {
+    /**
+     * Placeholder for an expression whose derivative vanishes. It never ends up in a Form, but
+     * is removed when the terms of a linearization are collected.
+     */
+    struct ZeroFEFunction
+    {
+    };
+
+    namespace internal
+    {
+      template <class T>
+      struct is_zero : std::is_same<T, ZeroFEFunction>
+      {
+      };
+
+      template <class T>
+      struct dependent_false : std::false_type
+      {
+      };
+
+      // add a single summand to the sum collected so far
+      template <class Sum, class Summand>
+      auto
+      add_term(const Sum& sum, const Summand& summand)
+      {
+        if constexpr(is_zero<Sum>::value)
+          return summand;
+        else
+          return sum + summand;
+      }
+
+      // add a single Form to the Forms collected so far
+      template <class FormsType, class FormType>
+      auto
+      add_form(const FormsType& forms, const FormType& new_form)
+      {
+        if constexpr(is_zero<FormsType>::value)
+          return new_form;
+        else
+          return forms + new_form;
+      }
+
+      /**
+       * The directional derivative of the terminal @p t in direction of the FEFunction
+       * @p increment_idx if @p t depends on the FEFunction @p unknown_idx, ZeroFEFunction
+       * otherwise.
+       */
+      template <unsigned int unknown_idx, unsigned int increment_idx,
+                template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+      auto
+      linearize_terminal(const T<rank, dim, idx>& t)
+      {
+        if constexpr(idx == unknown_idx)
+          return T<rank, dim, increment_idx>(t.name());
+        else
+          return ZeroFEFunction();
+      }
+
+      // coefficients and cell parameters do not depend on any FEFunction
+      template <class T>
+      struct is_constant : std::false_type
+      {
+      };
+
+      template <int rank, int dim, class Function, typename Number>
+      struct is_constant<Coefficient<rank, dim, Function, Number>> : std::true_type
+      {
+      };
+
+      template <int rank, int dim, unsigned int idx>
+      struct is_constant<CellParameter<rank, dim, idx>> : std::true_type
+      {
+      };
+
+      template <class Factor, class... Factors>
+      auto
+      get_factors(const ProductFEFunctions<Factor, Factors...>& product)
+      {
+        if constexpr(sizeof...(Factors) == 0)
+          return std::make_tuple(product.get_factor());
+        else
+          return std::tuple_cat(
+            std::make_tuple(product.get_factor()),
+            get_factors(static_cast<const ProductFEFunctions<Factors...>&>(product)));
+      }
+
+      template <class Factor, class... Factors>
+      auto
+      make_product(const Factor& factor, const Factors&... factors)
+      {
+        if constexpr(sizeof...(Factors) == 0)
+          return ProductFEFunctions<Factor>(factor);
+        else
+          return ProductFEFunctions<Factor, Factors...>(factor, make_product(factors...));
+      }
+
+      // the product of all factors in @p factors, the one at position @p i replaced by @p value
+      template <std::size_t i, class Value, class Tuple, std::size_t... indices>
+      auto
+      replace_factor(const Value& value, const Tuple& factors,
+                     std::index_sequence<indices...> /*unused*/)
+      {
+        const auto select = [&](auto index) -> decltype(auto) {
+          if constexpr(decltype(index)::value == i)
+            return value;
+          else
+            return std::get<decltype(index)::value>(factors);
+        };
+        return make_product(select(std::integral_constant<std::size_t, indices>())...);
+      }
+
+      template <std::size_t i, class Tuple, std::size_t... indices>
+      constexpr unsigned int
+      count_factor_type(std::index_sequence<indices...> /*unused*/)
+      {
+        return (0u + ... +
+                (std::is_same<std::tuple_element_t<indices, Tuple>,
+                              std::tuple_element_t<i, Tuple>>::value
+                   ? 1u
+                   : 0u));
+      }
+
+      template <std::size_t i, class Tuple, std::size_t... indices>
+      constexpr bool
+      is_first_of_type(std::index_sequence<indices...> /*unused*/)
+      {
+        return !(false || ... ||
+                 (indices < i && std::is_same<std::tuple_element_t<indices, Tuple>,
+                                              std::tuple_element_t<i, Tuple>>::value));
+      }
+
+      template <unsigned int unknown_idx, unsigned int increment_idx, class Sum, class Expr>
+      auto
+      add_linearization(const Sum& sum, const Expr& expr);
+
+      // apply @p add_factor to all factor positions in turn, threading the sum through
+      template <class AddFactor, class Sum, std::size_t i, std::size_t n>
+      auto
+      add_factors(const AddFactor& add_factor, const Sum& sum,
+                  std::integral_constant<std::size_t, i> index,
+                  std::integral_constant<std::size_t, n> size)
+      {
+        if constexpr(i == n)
+        {
+          (void)add_factor;
+          (void)index;
+          (void)size;
+          return sum;
+        }
+        else
+          return add_factors(
+            add_factor, add_factor(index, sum), std::integral_constant<std::size_t, i + 1>(), size);
+      }
+
+      /**
+       * Product rule. The factors of a product are equal up to type, since their scalar factors
+       * are kept outside of the product. So the terms belonging to factors of the same type
+       * coincide and are merged into a single term scaled by the number of such factors, e.g.
+       * the derivative of u*u*u is 3*u*u*e.
+       */
+      template <unsigned int unknown_idx, unsigned int increment_idx, class Sum, class Tuple,
+                std::size_t... indices>
+      auto
+      add_product_linearization(const Sum& sum, const Tuple& factors,
+                                std::index_sequence<indices...> sequence)
+      {
+        const auto add_factor = [&](auto index, const auto& current_sum) {
+          constexpr std::size_t i = decltype(index)::value;
+          using FactorType = std::tuple_element_t<i, Tuple>;
+          static_assert(Traits::is_fe_function_terminal<FactorType>::value ||
+                          is_constant<FactorType>::value,
+                        "Only products of FEFunction terminals can be linearized!");
+          const auto derivative = [&]() {
+            if constexpr(is_constant<FactorType>::value)
+              return ZeroFEFunction();
+            else
+              return linearize_terminal<unknown_idx, increment_idx>(std::get<i>(factors));
+          }();
+          if constexpr(is_zero<std::decay_t<decltype(derivative)>>::value ||
+                       !is_first_of_type<i, Tuple>(sequence))
+            return current_sum;
+          else
+          {
+            const auto term = replace_factor<i>(derivative, factors, sequence);
+            constexpr unsigned int count = count_factor_type<i, Tuple>(sequence);
+            if constexpr(count == 1)
+              return add_term(current_sum, term);
+            else
+              return add_term(current_sum, term * double(count));
+          }
+        };
+        return add_factors(add_factor, sum, std::integral_constant<std::size_t, 0>(),
+                           std::integral_constant<std::size_t, sizeof...(indices)>());
+      }
+
+      template <unsigned int unknown_idx, unsigned int increment_idx, class Sum, class Summand,
+                class... Summands>
+      auto
+      add_sum_linearization(const Sum& sum, const SumFEFunctions<Summand, Summands...>& expr)
+      {
+        const auto new_sum =
+          add_linearization<unknown_idx, increment_idx>(sum, expr.get_summand());
+        if constexpr(sizeof...(Summands) == 0)
+          return new_sum;
+        else
+          return add_sum_linearization<unknown_idx, increment_idx>(
+            new_sum, static_cast<const SumFEFunctions<Summands...>&>(expr));
+      }
+
+      template <class T>
+      struct is_sum : std::false_type
+      {
+      };
+
+      template <typename... Types>
+      struct is_sum<SumFEFunctions<Types...>> : std::true_type
+      {
+      };
+
+      template <class Sum, class Summand, class... Summands>
+      auto
+      add_summands(const Sum& sum, const SumFEFunctions<Summand, Summands...>& terms)
+      {
+        const auto new_sum = add_term(sum, terms.get_summand());
+        if constexpr(sizeof...(Summands) == 0)
+          return new_sum;
+        else
+          return add_summands(new_sum, static_cast<const SumFEFunctions<Summands...>&>(terms));
+      }
+
+      // add @p terms to @p sum, summand by summand if it is a sum itself
+      template <class Sum, class Terms>
+      auto
+      add_terms(const Sum& sum, const Terms& terms)
+      {
+        if constexpr(is_sum<Terms>::value)
+          return add_summands(sum, terms);
+        else
+          return add_term(sum, terms);
+      }
+
+      /**
+       * The derivative of an expression with a scalar factor, e.g. -u*u or 3*u*u*e, is the
+       * derivative of the expression without it, negated or scaled accordingly.
+       */
+      template <unsigned int unknown_idx, unsigned int increment_idx, class Sum, class Expr>
+      auto
+      add_scaled_linearization(const Sum& sum, const Expr& expr)
+      {
+        const auto derivative =
+          add_linearization<unknown_idx, increment_idx>(ZeroFEFunction(), expr.get_unscaled());
+        if constexpr(is_zero<std::decay_t<decltype(derivative)>>::value)
+          return sum;
+        else if constexpr(is_negated<Expr>::value)
+          return add_terms(sum, -derivative);
+        else
+          return add_terms(sum, derivative * expr.scalar_factor);
+      }
+
+      // expressions f(u) of a single FEFunction terminal u providing f' as outer_derivative()
+      template <class T, class Enable = void>
+      struct is_function_of_terminal : std::false_type
+      {
+      };
+
+      template <class T>
+      struct is_function_of_terminal<
+        T, std::void_t<decltype(std::declval<const T&>().get_fe_function())>> : std::true_type
+      {
+      };
+
+      /**
+       * Chain rule, e.g. for pow() and polynomial(): f(u) is linearized to f'(u) times the
+       * derivative of u. f' is a number if f is linear, and u may have a scalar factor.
+       */
+      template <unsigned int unknown_idx, unsigned int increment_idx, class Sum, class Expr>
+      auto
+      add_chain_rule_linearization(const Sum& sum, const Expr& expr)
+      {
+        const auto derivative =
+          add_linearization<unknown_idx, increment_idx>(ZeroFEFunction(), expr.get_fe_function());
+        if constexpr(is_zero<std::decay_t<decltype(derivative)>>::value)
+          return sum;
+        else
+          return add_term(sum, expr.outer_derivative() * derivative);
+      }
+
+      /**
+       * Add the directional derivative of @p expr to @p sum, term by term.
+       */
+      template <unsigned int unknown_idx, unsigned int increment_idx, class Sum, class Expr>
+      auto
+      add_linearization(const Sum& sum, const Expr& expr)
+      {
+        if constexpr(Traits::is_fe_function_terminal<Expr>::value)
+          return add_term(sum, linearize_terminal<unknown_idx, increment_idx>(expr));
+        else if constexpr(is_constant<Expr>::value)
+          return sum;
+        else if constexpr(is_sum<Expr>::value)
+          return add_sum_linearization<unknown_idx, increment_idx>(sum, expr);
+        else if constexpr(has_scalar_factor<Expr>::value)
+          return add_scaled_linearization<unknown_idx, increment_idx>(sum, expr);
+        else if constexpr(is_function_of_terminal<Expr>::value)
+          return add_chain_rule_linearization<unknown_idx, increment_idx>(sum, expr);
+        else if constexpr(Traits::is_fe_function_product<Expr>::value)
+        {
+          const auto factors = get_factors(expr);
+          return add_product_linearization<unknown_idx, increment_idx>(
+            sum,
+            factors,
+            std::make_index_sequence<std::tuple_size<std::decay_t<decltype(factors)>>::value>());
+        }
+        else
+        {
+          static_assert(dependent_false<Expr>::value,
+                        "linearize is not implemented for this expression!");
+          return sum;
+        }
+      }
+
+      template <unsigned int unknown_idx, unsigned int increment_idx, class FormsType,
+                class Test, class Expr, typename number>
+      auto
+      add_form_linearization(const FormsType& forms, const Form<Test, Expr, number>& old_form)
+      {
+        const auto derivative =
+          add_linearization<unknown_idx, increment_idx>(ZeroFEFunction(), old_form.expr);
+        if constexpr(is_zero<std::decay_t<decltype(derivative)>>::value)
+          return forms;
+        else
+          return add_form(forms, Form<Test, std::decay_t<decltype(derivative)>, number>(
+                                   old_form.test, derivative));
+      }
+
+      template <unsigned int unknown_idx, unsigned int increment_idx, class FormsType,
+                class FormType, class... FormTypes>
+      auto
+      add_forms_linearization(const FormsType& forms,
+                              const Forms<FormType, FormTypes...>& old_forms)
+      {
+        const auto new_forms =
+          add_form_linearization<unknown_idx, increment_idx>(forms, old_forms.get_form());
+        if constexpr(sizeof...(FormTypes) == 0)
+          return new_forms;
+        else
+          return add_forms_linearization<unknown_idx, increment_idx>(
+            new_forms, static_cast<const Forms<FormTypes...>&>(old_forms));
+      }
+    } // namespace internal
+
+    /**
+     * Linearize @p forms with respect to the FEFunction with index @p unknown_idx. The result
+     * is the Gateaux derivative in direction of the FEFunction with index @p increment_idx,
+     * i.e. the Jacobian of @p forms as a Form or Forms object that can be used by a
+     * MatrixFreeIntegrator. The FEFunction @p unknown_idx has to be provided as the
+     * linearization point, see MatrixFreeIntegrator::set_nonlinearities().
+     *
+     * The derivative is built term by term from the sum and product rules, and terms that do
+     * not depend on the unknown are dropped. Only sums and products of FEFunction terminals
+     * such as FEFunction, FEGradient or FEJump and of Coefficient or CellParameter objects are
+     * supported, as well as functions of a terminal like pow(), polynomial() or exp(), which are
+     * not part of a product.
+     */
+    template <unsigned int unknown_idx, unsigned int increment_idx, class FormsType>
+    auto
+    linearize(const FormsType& forms)
+    {
+      static_assert(unknown_idx != increment_idx,
+                    "The unknown and the increment need to be different FEFunctions!");
+      const auto derivative = [&]() {
+        if constexpr(Traits::is_form<FormsType>::value)
+          return internal::add_form_linearization<unknown_idx, increment_idx>(
+            ZeroFEFunction(), forms);
+        else
+          return internal::add_forms_linearization<unknown_idx, increment_idx>(
+            ZeroFEFunction(), forms);
+      }();
+      static_assert(!internal::is_zero<std::decay_t<decltype(derivative)>>::value,
+                    "The forms do not depend on the unknown!");
+      return derivative;
+    }
+  } // namespace MatrixFree
+} // namespace dealii
+} // namespace CFL
+
+#endif // cfl_dealii_matrixfree_linearize_h
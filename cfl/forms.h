@@ -4,6 +4,7 @@
 #include <array>
 #include <iostream>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include <cfl/traits.h>
@@ -105,6 +106,46 @@ struct form_evaluate_aux<1, Test, Expr>
   }
 };
 
+/**
+ * The test functions whose forms have already been submitted in Forms::evaluate.
+ */
+template <typename... Tests>
+struct SubmittedTests
+{
+};
+
+/**
+ * The quadrature point data of block @p index a test function submits to, either the values or
+ * the gradients. Different test functions submitting to the same slot, e.g. the gradient and the
+ * divergence of the same block, overwrite each other's data and must therefore be added up, see
+ * Forms::evaluate.
+ */
+template <unsigned int index, bool gradient>
+struct SubmissionSlot
+{
+  static constexpr unsigned int fe_number = index;
+  static constexpr bool is_gradient = gradient;
+};
+
+namespace Traits
+{
+  /**
+   * The SubmissionSlot of @p Test, given by <tt>Test::Slot</tt>. Test functions without a
+   * slot only share their quadrature point data with themselves.
+   */
+  template <class Test, class Enable = void>
+  struct submission_slot
+  {
+    using type = Test;
+  };
+
+  template <class Test>
+  struct submission_slot<Test, decltype(typename Test::Slot(), void())>
+  {
+    using type = typename Test::Slot;
+  };
+} // namespace Traits
+
 template <typename... Types>
 class Forms;
 
@@ -115,12 +156,18 @@ template <class Test, class Expr, typename number = double>
 class Form final
 {
 public:
+  using TestType = Test;
+
   const Test test;
   const Expr expr;
 
   static constexpr unsigned int fe_number = Test::index;
   static constexpr bool integrate_value = Test::integrate_value;
   static constexpr bool integrate_gradient = Test::integrate_gradient;
+  static constexpr IntegrationDomain integration_domain = Traits::integration_domain<Test>::value;
+  static constexpr bool has_cell_forms = (integration_domain == IntegrationDomain::cell);
+  static constexpr bool has_face_forms = (integration_domain == IntegrationDomain::face);
+  static constexpr bool has_boundary_forms = (integration_domain == IntegrationDomain::boundary);
 
   Form(Test test_, Expr expr_)
     : test(std::move(test_))
@@ -143,12 +190,26 @@ public:
     return form_latex_aux<Test::TensorTraits::rank, Test, Expr>()(test, expr);
   }
 
+  /**
+   * True if the form is integrated over the mesh objects @p FEEvaluation works on. All other
+   * forms are skipped when evaluating with @p FEEvaluation.
+   */
+  template <class FEEvaluation>
+  static constexpr bool
+  is_evaluated_by()
+  {
+    return integration_domain == Traits::integration_domain<FEEvaluation>::value;
+  }
+
+  template <class FEEvaluation>
+  using IsEvaluatedBy = std::integral_constant<bool, is_evaluated_by<FEEvaluation>()>;
+
   template <class FEEvaluation>
   static void
   integrate(FEEvaluation& phi)
   {
     // only to be used if there is only one form!
-    phi.template integrate<fe_number>(integrate_value, integrate_gradient);
+    integrate(phi, IsEvaluatedBy<FEEvaluation>());
   }
 
   template <class FEEvaluation>
@@ -156,7 +217,7 @@ public:
   set_integration_flags(FEEvaluation& phi)
   {
     // only to be used if there is only one form!
-    phi.template set_integration_flags<fe_number>(integrate_value, integrate_gradient);
+    set_integration_flags(phi, IsEvaluatedBy<FEEvaluation>());
   }
 
   template <class FEEvaluation>
@@ -164,7 +225,7 @@ public:
   set_evaluation_flags(FEEvaluation& phi) const
   {
     // only to be used if there is only one form!
-    expr.set_evaluation_flags(phi);
+    set_evaluation_flags(phi, IsEvaluatedBy<FEEvaluation>());
   }
 
   number
@@ -178,8 +239,7 @@ public:
   evaluate(FEEvaluation& phi, unsigned int q) const
   {
     // only to be used if there is only one form!
-    const auto value = expr.value(phi, q);
-    Test::submit(phi, q, value);
+    evaluate(phi, q, IsEvaluatedBy<FEEvaluation>());
   }
 
   template <class FEEvaluation>
@@ -196,6 +256,20 @@ public:
     Test::submit(phi, q, value);
   }
 
+  /**
+   * Like submit(), but add @p value to the data already submitted to the SubmissionSlot of the
+   * test function instead of overwriting it.
+   */
+  template <class FEEvaluation, typename ValueType>
+  static void
+  submit_add(FEEvaluation& phi, unsigned int q, const ValueType& value)
+  {
+    using Slot = typename Traits::submission_slot<Test>::type;
+    const auto submitted = phi.template get_submitted<Slot::fe_number, Slot::is_gradient>(q);
+    Test::submit(phi, q, value);
+    phi.template add_submitted<Slot::fe_number, Slot::is_gradient>(submitted, q);
+  }
+
   template <class TestNew, class ExprNew>
   Forms<Form<Test, Expr>, Form<TestNew, ExprNew>>
   operator+(const Form<TestNew, ExprNew>& new_form) const
@@ -211,12 +285,68 @@ public:
     return old_form + *this;
   }
 
-  Form<Test, Expr, number>
+  // the sign may be part of the type of the negated expression
+  auto
   operator-() const
   {
-    const typename std::remove_reference<decltype(*this)>::type newform(test, -expr);
+    const Form<Test, decltype(-expr), number> newform(test, -expr);
     return newform;
   }
+
+private:
+  // The overloads taking std::false_type skip forms living on other mesh objects.
+  template <class FEEvaluation>
+  static void
+  integrate(FEEvaluation& phi, std::true_type /*is_evaluated*/)
+  {
+    phi.template integrate<fe_number>(integrate_value, integrate_gradient);
+  }
+
+  template <class FEEvaluation>
+  static void
+  integrate(FEEvaluation& /*phi*/, std::false_type /*is_evaluated*/)
+  {
+  }
+
+  template <class FEEvaluation>
+  static void
+  set_integration_flags(FEEvaluation& phi, std::true_type /*is_evaluated*/)
+  {
+    phi.template set_integration_flags<fe_number>(integrate_value, integrate_gradient);
+  }
+
+  template <class FEEvaluation>
+  static void
+  set_integration_flags(FEEvaluation& /*phi*/, std::false_type /*is_evaluated*/)
+  {
+  }
+
+  template <class FEEvaluation>
+  void
+  set_evaluation_flags(FEEvaluation& phi, std::true_type /*is_evaluated*/) const
+  {
+    expr.set_evaluation_flags(phi);
+  }
+
+  template <class FEEvaluation>
+  void
+  set_evaluation_flags(FEEvaluation& /*phi*/, std::false_type /*is_evaluated*/) const
+  {
+  }
+
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q, std::true_type /*is_evaluated*/) const
+  {
+    const auto value = expr.value(phi, q);
+    Test::submit(phi, q, value);
+  }
+
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& /*phi*/, unsigned int /*q*/, std::false_type /*is_evaluated*/) const
+  {
+  }
 };
 
 namespace Traits
@@ -266,9 +396,67 @@ form(const Expr& e, const Test& t)
   return Form<Test, Expr>(t, e);
 }
 
+namespace Traits
+{
+  /**
+   * True if @p T is one of @p Types.
+   */
+  template <class T, typename... Types>
+  struct is_one_of : std::false_type
+  {
+  };
+
+  template <class T, class Type, typename... Types>
+  struct is_one_of<T, Type, Types...>
+    : std::integral_constant<bool, std::is_same<T, Type>::value || is_one_of<T, Types...>::value>
+  {
+  };
+
+  /**
+   * True if one of the Form objects @p FormTypes is tested by @p Test.
+   */
+  template <class Test, typename... FormTypes>
+  struct is_tested_by : is_one_of<Test, typename FormTypes::TestType...>
+  {
+  };
+
+  /**
+   * True if one of the Form objects @p FormTypes evaluated by @p FEEvaluation is tested by a
+   * test function other than @p Test and those in @p SubmittedTestsType but submits to the same
+   * SubmissionSlot as @p Test, i.e. if some other form writes the quadrature point data of
+   * @p Test before the forms tested by @p Test are submitted in Forms::evaluate.
+   */
+  template <class Test, class FEEvaluation, class SubmittedTestsType, typename... FormTypes>
+  struct shares_submission_slot : std::false_type
+  {
+  };
+
+  template <class Test, class FEEvaluation, typename... Tests, class FormType,
+            typename... FormTypes>
+  struct shares_submission_slot<Test, FEEvaluation, SubmittedTests<Tests...>, FormType,
+                                FormTypes...>
+    : std::integral_constant<
+        bool,
+        (FormType::template is_evaluated_by<FEEvaluation>() &&
+         !std::is_same<Test, typename FormType::TestType>::value &&
+         !is_one_of<typename FormType::TestType, Tests...>::value &&
+         std::is_same<typename submission_slot<Test>::type,
+                      typename submission_slot<typename FormType::TestType>::type>::value) ||
+          shares_submission_slot<Test, FEEvaluation, SubmittedTests<Tests...>,
+                                 FormTypes...>::value>
+  {
+  };
+} // namespace Traits
+
 template <typename... Types>
 class Forms;
 
+/**
+ * A collection of Form objects. All forms tested by the same test function are evaluated
+ * together, i.e. their values are added up and submitted once per quadrature point. Test
+ * functions submitting to the same SubmissionSlot add their contributions to the data submitted
+ * before.
+ */
 template <typename FormType>
 class Forms<FormType>
 {
@@ -276,6 +464,9 @@ public:
   static constexpr bool integrate_value = FormType::integrate_value;
   static constexpr bool integrate_gradient = FormType::integrate_gradient;
   static constexpr unsigned int fe_number = FormType::fe_number;
+  static constexpr bool has_cell_forms = FormType::has_cell_forms;
+  static constexpr bool has_face_forms = FormType::has_face_forms;
+  static constexpr bool has_boundary_forms = FormType::has_boundary_forms;
 
   explicit Forms(const FormType& form_)
     : form(form_)
@@ -289,39 +480,78 @@ public:
   static void
   set_integration_flags(FEEvaluation& phi)
   {
-    phi.template set_integration_flags<fe_number>(integrate_value, integrate_gradient);
+    FormType::set_integration_flags(phi);
   }
 
   template <class FEEvaluation>
   void
   set_evaluation_flags(FEEvaluation& phi) const
   {
-    form.expr.set_evaluation_flags(phi);
+    form.set_evaluation_flags(phi);
   }
 
   template <class FEEvaluation>
   void
   evaluate(FEEvaluation& phi, unsigned int q) const
   {
-#ifdef DEBUG_OUTPUT
-    std::cout << "expecting value " << fe_number << std::endl;
-#endif
-    const auto value = form.value(phi, q);
-#ifdef DEBUG_OUUTPUT
-    std::cout << "expecting submit " << fe_number << std::endl;
-#endif
-    form.submit(phi, q, value);
+    form.evaluate(phi, q);
+  }
+
+  template <class FEEvaluation, typename... Tests>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q, SubmittedTests<Tests...> /*submitted*/) const
+  {
+    using Test = typename FormType::TestType;
+    evaluate(phi, q, std::integral_constant<bool, !Traits::is_one_of<Test, Tests...>::value>());
+  }
+
+  /**
+   * The sum of the values of all forms tested by @p Test.
+   */
+  template <class Test, class FEEvaluation>
+  auto
+  tested_value(FEEvaluation& phi, unsigned int q) const
+  {
+    static_assert(std::is_same<Test, typename FormType::TestType>::value,
+                  "No form is tested by this test function!");
+    return form.value(phi, q);
   }
 
   template <class FEEvaluation>
   static void
   integrate(FEEvaluation& phi)
   {
-    phi.template integrate<fe_number>(integrate_value, integrate_gradient);
+    FormType::integrate(phi);
+  }
+
+  auto
+  operator-() const
+  {
+    return Forms<decltype(-form)>(-form);
+  }
+
+  const FormType&
+  get_form() const
+  {
+    return form;
   }
 
 private:
-  const FormType& form;
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q, std::true_type /*is_not_submitted*/) const
+  {
+    form.evaluate(phi, q);
+  }
+
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& /*phi*/, unsigned int /*q*/,
+           std::false_type /*is_not_submitted*/) const
+  {
+  }
+
+  const FormType form;
 };
 
 template <typename FormType, typename... Types>
@@ -331,6 +561,12 @@ public:
   static constexpr bool integrate_value = FormType::integrate_value;
   static constexpr bool integrate_gradient = FormType::integrate_gradient;
   static constexpr unsigned int fe_number = FormType::fe_number;
+  static constexpr bool has_cell_forms =
+    FormType::has_cell_forms || Forms<Types...>::has_cell_forms;
+  static constexpr bool has_face_forms =
+    FormType::has_face_forms || Forms<Types...>::has_face_forms;
+  static constexpr bool has_boundary_forms =
+    FormType::has_boundary_forms || Forms<Types...>::has_boundary_forms;
 
   Forms(const FormType& form_, const Forms<Types...>& old_form)
     : Forms<Types...>(old_form)
@@ -358,11 +594,23 @@ public:
     return Forms<Form<Test, Expr>, FormType, Types...>(new_form, *this);
   }
 
+  auto
+  operator-() const
+  {
+    return make_forms(-form, -static_cast<const Forms<Types...>&>(*this));
+  }
+
+  const FormType&
+  get_form() const
+  {
+    return form;
+  }
+
   template <class FEEvaluation>
   static void
   set_integration_flags(FEEvaluation& phi)
   {
-    phi.template set_integration_flags<fe_number>(integrate_value, integrate_gradient);
+    FormType::set_integration_flags(phi);
     Forms<Types...>::set_integration_flags(phi);
   }
 
@@ -370,7 +618,7 @@ public:
   void
   set_evaluation_flags(FEEvaluation& phi) const
   {
-    form.expr.set_evaluation_flags(phi);
+    form.set_evaluation_flags(phi);
     Forms<Types...>::set_evaluation_flags(phi);
   }
 
@@ -378,30 +626,131 @@ public:
   void
   evaluate(FEEvaluation& phi, unsigned int q) const
   {
+    evaluate(phi, q, SubmittedTests<>());
+  }
+
+  /**
+   * Evaluate all forms whose test function is not in @p Tests. The first form tested by a
+   * test function adds up the values of all forms tested by it and submits the sum. The forms
+   * further down the list are submitted first, so the sum is added to the submitted data if one
+   * of them uses the same SubmissionSlot.
+   */
+  template <class FEEvaluation, typename... Tests>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q, SubmittedTests<Tests...> submitted) const
+  {
+    evaluate(phi,
+             q,
+             submitted,
+             std::integral_constant<bool,
+                                    FormType::template is_evaluated_by<FEEvaluation>() &&
+                                      !Traits::is_one_of<Test, Tests...>::value>());
+  }
+
+  /**
+   * The sum of the values of all forms tested by @p TestSum.
+   */
+  template <class TestSum, class FEEvaluation>
+  auto
+  tested_value(FEEvaluation& phi, unsigned int q) const
+  {
+    return tested_value<TestSum>(phi,
+                                 q,
+                                 std::is_same<TestSum, Test>(),
+                                 Traits::is_tested_by<TestSum, Types...>());
+  }
+
+  template <class FEEvaluation>
+  static void
+  integrate(FEEvaluation& phi)
+  {
+    FormType::integrate(phi);
+    Forms<Types...>::integrate(phi);
+  }
+
+private:
+  using Test = typename FormType::TestType;
+
+  // the negated forms keep their order, but their types may change
+  template <class NewFormType, typename... NewTypes>
+  static Forms<NewFormType, NewTypes...>
+  make_forms(const NewFormType& new_form, const Forms<NewTypes...>& old_forms)
+  {
+    return Forms<NewFormType, NewTypes...>(new_form, old_forms);
+  }
+
+  template <class FEEvaluation, typename... Tests>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q, SubmittedTests<Tests...> /*submitted*/,
+           std::true_type /*submits*/) const
+  {
+    // All values are computed before anything is submitted, since submitting overwrites the
+    // quadrature point data.
 #ifdef DEBUG_OUTPUT
     std::cout << "expecting value " << fe_number << std::endl;
 #endif
-    const auto value = form.value(phi, q);
+    const auto value = tested_value<Test>(phi, q);
 #ifdef DEBUG_OUTPUT
     std::cout << "descending" << std::endl;
 #endif
-    Forms<Types...>::evaluate(phi, q);
+    Forms<Types...>::evaluate(phi, q, SubmittedTests<Tests..., Test>());
 #ifdef DEBUG_OUTPUT
     std::cout << "expecting submit " << fe_number << std::endl;
 #endif
-    form.submit(phi, q, value);
+    submit(phi,
+           q,
+           value,
+           Traits::shares_submission_slot<Test, FEEvaluation, SubmittedTests<Tests...>,
+                                          Types...>());
   }
 
-  template <class FEEvaluation>
+  template <class FEEvaluation, typename ValueType>
   static void
-  integrate(FEEvaluation& phi)
+  submit(FEEvaluation& phi, unsigned int q, const ValueType& value, std::true_type /*add*/)
   {
-    phi.template integrate<fe_number>(integrate_value, integrate_gradient);
-    Forms<Types...>::integrate(phi);
+    FormType::submit_add(phi, q, value);
   }
 
-private:
-  const FormType& form;
+  template <class FEEvaluation, typename ValueType>
+  static void
+  submit(FEEvaluation& phi, unsigned int q, const ValueType& value, std::false_type /*add*/)
+  {
+    FormType::submit(phi, q, value);
+  }
+
+  template <class FEEvaluation, typename... Tests>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q, SubmittedTests<Tests...> submitted,
+           std::false_type /*submits*/) const
+  {
+    Forms<Types...>::evaluate(phi, q, submitted);
+  }
+
+  template <class TestSum, class FEEvaluation>
+  auto
+  tested_value(FEEvaluation& phi, unsigned int q, std::true_type /*is_tested*/,
+               std::true_type /*rest_is_tested*/) const
+  {
+    return form.value(phi, q) + Forms<Types...>::template tested_value<TestSum>(phi, q);
+  }
+
+  template <class TestSum, class FEEvaluation>
+  auto
+  tested_value(FEEvaluation& phi, unsigned int q, std::true_type /*is_tested*/,
+               std::false_type /*rest_is_tested*/) const
+  {
+    return form.value(phi, q);
+  }
+
+  template <class TestSum, class FEEvaluation>
+  auto
+  tested_value(FEEvaluation& phi, unsigned int q, std::false_type /*is_tested*/,
+               std::true_type /*rest_is_tested*/) const
+  {
+    return Forms<Types...>::template tested_value<TestSum>(phi, q);
+  }
+
+  const FormType form;
 };
 } // namespace CFL
 
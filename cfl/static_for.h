@@ -1,6 +1,9 @@
 #ifndef STATIC_FOR_H
 #define STATIC_FOR_H
 
+#include <type_traits>
+#include <utility>
+
 template <int First, int Last, template <int> class FunctorT>
 struct static_for_new
 {
@@ -198,4 +201,20 @@ static_for(functor_types&&... functor_args)
     std::forward<functor_types>(functor_args)...);
 }
 
+// third approach: the loop index is passed as std::integral_constant such that it can be used
+// as a template argument inside a generic lambda
+template <typename Fn, unsigned int... indices>
+inline void
+static_for_each_impl(Fn const& fn, std::integer_sequence<unsigned int, indices...> /*unused*/)
+{
+  (fn(std::integral_constant<unsigned int, indices>()), ...);
+}
+
+template <unsigned int count, typename Fn>
+inline void
+static_for_each(Fn const& fn)
+{
+  static_for_each_impl(fn, std::make_integer_sequence<unsigned int, count>());
+}
+
 #endif // STATIC_FOR_H
@@ -1,8 +1,20 @@
 #ifndef cfl_traits_h
 #define cfl_traits_h
 
+#include <type_traits>
+
 namespace CFL
 {
+/**
+ * \brief The mesh objects a Form is integrated over.
+ */
+enum class IntegrationDomain
+{
+  cell,
+  face,
+  boundary
+};
+
 namespace Traits
 {
   template <class VectorType>
@@ -135,6 +147,16 @@ namespace Traits
     static constexpr bool value = false;
   };
 
+  /**
+   * \brief True for a single (derivative of a) finite element function
+   * that is not composed of other finite element functions
+   */
+  template <class T, class Enable = void>
+  struct is_fe_function_terminal
+  {
+    static constexpr bool value = false;
+  };
+
   /**
    * \brief True if the object is a CFL unary operator
    */
@@ -163,6 +185,26 @@ namespace Traits
     static constexpr bool value = false;
   };
 
+  /**
+   * \brief The IntegrationDomain of a test function set or of the
+   * object a Form is evaluated with.
+   *
+   * Classes living on faces or on the boundary declare a static member
+   * <tt>integration_domain</tt>. Everything else is integrated over
+   * cells.
+   */
+  template <class T, class Enable = void>
+  struct integration_domain
+  {
+    static constexpr IntegrationDomain value = IntegrationDomain::cell;
+  };
+
+  template <class T>
+  struct integration_domain<T, decltype(T::integration_domain, void())>
+  {
+    static constexpr IntegrationDomain value = T::integration_domain;
+  };
+
   /**
    * \brief Objectys need binding to mesh objects in loop
    */
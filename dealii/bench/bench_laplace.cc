@@ -0,0 +1,145 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "bench_utils.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+// the Laplace operator written directly with FEEvaluation, as in step-37
+template <int dim, unsigned int degree>
+class LaplaceOperator
+{
+public:
+  explicit LaplaceOperator(const ::dealii::MatrixFree<dim, double>& data_)
+    : data(data_)
+  {
+  }
+
+  void
+  vmult(VectorType& dst, const VectorType& src) const
+  {
+    dst = 0.;
+    data.cell_loop(&LaplaceOperator::local_apply, this, dst, src);
+  }
+
+private:
+  void
+  local_apply(const ::dealii::MatrixFree<dim, double>& mf, VectorType& dst, const VectorType& src,
+              const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    FEEvaluation<dim, degree, degree + 1, 1, double> phi(mf);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(src);
+      phi.evaluate(false, true);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        phi.submit_gradient(phi.get_gradient(q), q);
+      phi.integrate(false, true);
+      phi.distribute_local_to_global(dst);
+    }
+  }
+
+  const ::dealii::MatrixFree<dim, double>& data;
+};
+
+template <int dim, unsigned int degree>
+struct LaplaceBenchmark
+{
+  static void
+  run(const Bench::Parameters& parameters, Bench::Report& report)
+  {
+    FE_Q<dim> fe(degree);
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+    TestFunction<0, dim, 0> v;
+    FEFunction<0, dim, 0> u("u");
+    auto f = form(grad(u), grad(v));
+
+    Bench::for_each_refinement(dim, degree, 1, parameters.max_dofs, [&](unsigned int refine) {
+      parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+      GridGenerator::hyper_cube(tria);
+      tria.refine_global(refine);
+      DoFHandler<dim> dof(tria);
+      dof.distribute_dofs(fe);
+      ConstraintMatrix constraints;
+      constraints.close();
+
+      typename ::dealii::MatrixFree<dim, double>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        ::dealii::MatrixFree<dim, double>::AdditionalData::none;
+      additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+      ::dealii::MatrixFree<dim, double> data;
+      data.reinit(dof, constraints, QGauss<1>(degree + 1), additional_data);
+
+      MatrixFreeIntegrator<dim, VectorType, decltype(f), decltype(fe_datas)> cfl_op;
+      cfl_op.initialize(data, f, fe_datas);
+      const LaplaceOperator<dim, degree> hand_coded_op(data);
+
+      VectorType src, dst;
+      data.initialize_dof_vector(src);
+      data.initialize_dof_vector(dst);
+      for (auto& entry : src)
+        entry = 1.;
+      report.measure(degree, refine, data, cfl_op, hand_coded_op, dst, src, parameters);
+    });
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  try
+  {
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    const Bench::Parameters parameters(argc, argv, "laplace");
+    Bench::Report report("laplace");
+    Bench::for_degrees<2, 1, 9>::run<LaplaceBenchmark>(parameters, report);
+    Bench::for_degrees<3, 1, 9>::run<LaplaceBenchmark>(parameters, report);
+    report.write(parameters.output);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// Applying the CFL Laplace operator to several vectors at once, MatrixFreeIntegrator::vmult
+// with std::vector arguments, compared with one vmult per vector. Both times are for all
+// n_vectors vectors.
+
+#include "bench_utils.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+constexpr unsigned int n_vectors = 4;
+
+// apply @p op to n_vectors copies of src, either in one call or vector by vector
+template <class Operator, bool multiple>
+class MultipleVmult
+{
+public:
+  MultipleVmult(const Operator& op_, const VectorType& src)
+    : op(op_)
+    , dsts(n_vectors, src)
+    , srcs(n_vectors, src)
+  {
+    for (unsigned int v = 0; v < n_vectors; ++v)
+      srcs[v] *= 1. + v;
+  }
+
+  void
+  vmult(VectorType& /*dst*/, const VectorType& /*src*/) const
+  {
+    if (multiple)
+      op.vmult(dsts, srcs);
+    else
+      for (unsigned int v = 0; v < n_vectors; ++v)
+        op.vmult(dsts[v], srcs[v]);
+  }
+
+private:
+  const Operator& op;
+  mutable std::vector<VectorType> dsts;
+  std::vector<VectorType> srcs;
+};
+
+template <int dim, unsigned int degree>
+struct MultipleBenchmark
+{
+  static void
+  run(const Bench::Parameters& parameters, Bench::Report& report)
+  {
+    FE_Q<dim> fe(degree);
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+    TestFunction<0, dim, 0> v;
+    FEFunction<0, dim, 0> u("u");
+    auto f = form(grad(u), grad(v));
+
+    Bench::for_each_refinement(dim, degree, 1, parameters.max_dofs, [&](unsigned int refine) {
+      parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+      GridGenerator::hyper_cube(tria);
+      tria.refine_global(refine);
+      DoFHandler<dim> dof(tria);
+      dof.distribute_dofs(fe);
+      ConstraintMatrix constraints;
+      constraints.close();
+
+      typename ::dealii::MatrixFree<dim, double>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        ::dealii::MatrixFree<dim, double>::AdditionalData::none;
+      additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+      ::dealii::MatrixFree<dim, double> data;
+      data.reinit(dof, constraints, QGauss<1>(degree + 1), additional_data);
+
+      using Operator = MatrixFreeIntegrator<dim, VectorType, decltype(f), decltype(fe_datas)>;
+      Operator cfl_op;
+      cfl_op.initialize(data, f, fe_datas);
+
+      VectorType src, dst;
+      data.initialize_dof_vector(src);
+      data.initialize_dof_vector(dst);
+      for (auto& entry : src)
+        entry = 1.;
+      const MultipleVmult<Operator, true> multiple_op(cfl_op, src);
+      const MultipleVmult<Operator, false> single_op(cfl_op, src);
+      report.measure(degree, refine, data, multiple_op, single_op, dst, src, parameters);
+    });
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  try
+  {
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    const Bench::Parameters parameters(argc, argv, "multiple");
+    Bench::Report report("multiple", "multiple", "single");
+    Bench::for_degrees<2, 1, 9>::run<MultipleBenchmark>(parameters, report);
+    Bench::for_degrees<3, 1, 9>::run<MultipleBenchmark>(parameters, report);
+    report.write(parameters.output);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,179 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "bench_utils.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/dealii_matrixfree_linearize.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+using VectorType = LinearAlgebra::distributed::BlockVector<double>;
+
+constexpr double alpha = 1.;
+
+/**
+ * The Jacobian of matrixfree_schloegl.cc, (De, Dv) + (3*u*u*e - alpha*e, v), written directly
+ * with FEEvaluation. Like the CFL operator, the linearization point u is read from block 1 of
+ * @p linearization_point and block 1 of the source vector is passed through.
+ */
+template <int dim, unsigned int degree>
+class SchloeglOperator
+{
+public:
+  SchloeglOperator(const ::dealii::MatrixFree<dim, double>& data_,
+                   const VectorType& linearization_point_)
+    : data(data_)
+    , linearization_point(linearization_point_)
+  {
+  }
+
+  void
+  vmult(VectorType& dst, const VectorType& src) const
+  {
+    dst.block(0) = 0.;
+    data.cell_loop(&SchloeglOperator::local_apply, this, dst.block(0), src.block(0));
+    dst.block(1) = src.block(1);
+  }
+
+private:
+  void
+  local_apply(const ::dealii::MatrixFree<dim, double>& mf,
+              LinearAlgebra::distributed::Vector<double>& dst,
+              const LinearAlgebra::distributed::Vector<double>& src,
+              const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    FEEvaluation<dim, degree, degree + 1, 1, double> phi_e(mf, 0);
+    FEEvaluation<dim, degree, degree + 1, 1, double> phi_u(mf, 1);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi_e.reinit(cell);
+      phi_e.read_dof_values(src);
+      phi_e.evaluate(true, true);
+      phi_u.reinit(cell);
+      phi_u.read_dof_values(linearization_point.block(1));
+      phi_u.evaluate(true, false);
+      for (unsigned int q = 0; q < phi_e.n_q_points; ++q)
+      {
+        const VectorizedArray<double> u = phi_u.get_value(q);
+        phi_e.submit_value((3. * u * u - alpha) * phi_e.get_value(q), q);
+        phi_e.submit_gradient(phi_e.get_gradient(q), q);
+      }
+      phi_e.integrate(true, true);
+      phi_e.distribute_local_to_global(dst);
+    }
+  }
+
+  const ::dealii::MatrixFree<dim, double>& data;
+  const VectorType& linearization_point;
+};
+
+template <int dim, unsigned int degree>
+struct SchloeglBenchmark
+{
+  static void
+  run(const Bench::Parameters& parameters, Bench::Report& report)
+  {
+    FE_Q<dim> fe(degree);
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata_e(fe);
+    FEData<FE_Q, degree, 1, dim, 1, degree> fedata_u(fe);
+    auto fe_datas = (fedata_e, fedata_u);
+
+    TestFunction<0, dim, 0> v;
+    FEFunction<0, dim, 1> u("u");
+    auto rhs = form(-grad(u), grad(v)) + form(polynomial(u, 0., alpha, 0., -1.), v);
+    auto f = linearize<1, 0>(-rhs);
+
+    Bench::for_each_refinement(dim, degree, 2, parameters.max_dofs, [&](unsigned int refine) {
+      parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+      GridGenerator::hyper_cube(tria);
+      tria.refine_global(refine);
+      DoFHandler<dim> dof(tria);
+      dof.distribute_dofs(fe);
+      ConstraintMatrix constraints;
+      constraints.close();
+
+      typename ::dealii::MatrixFree<dim, double>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        ::dealii::MatrixFree<dim, double>::AdditionalData::none;
+      additional_data.mapping_update_flags = update_values | update_gradients | update_JxW_values;
+      const std::vector<const DoFHandler<dim>*> dofs{ &dof, &dof };
+      const std::vector<const ConstraintMatrix*> constraints_pointers{ &constraints,
+                                                                       &constraints };
+      ::dealii::MatrixFree<dim, double> data;
+      data.reinit(dofs, constraints_pointers, QGauss<1>(degree + 1), additional_data);
+
+      VectorType src(2), dst(2), solution(2);
+      for (unsigned int b = 0; b < 2; ++b)
+      {
+        data.initialize_dof_vector(src.block(b), b);
+        data.initialize_dof_vector(dst.block(b), b);
+        data.initialize_dof_vector(solution.block(b), b);
+      }
+      src.collect_sizes();
+      dst.collect_sizes();
+      solution.collect_sizes();
+      src = 1.;
+      solution = 0.5;
+
+      MatrixFreeIntegrator<dim, VectorType, decltype(f), decltype(fe_datas)> cfl_op;
+      cfl_op.initialize(data, f, fe_datas);
+      cfl_op.set_nonlinearities({ false, true }, solution);
+      const SchloeglOperator<dim, degree> hand_coded_op(data, solution);
+      report.measure(degree, refine, data, cfl_op, hand_coded_op, dst, src, parameters);
+    });
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  try
+  {
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    const Bench::Parameters parameters(argc, argv, "schloegl");
+    Bench::Report report("schloegl");
+    Bench::for_degrees<2, 1, 9>::run<SchloeglBenchmark>(parameters, report);
+    Bench::for_degrees<3, 1, 9>::run<SchloeglBenchmark>(parameters, report);
+    report.write(parameters.output);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "bench_utils.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+using VectorType = LinearAlgebra::distributed::BlockVector<double>;
+
+// the Stokes operator of matrixfree_stokes.cc written directly with FEEvaluation
+template <int dim, unsigned int degree>
+class StokesOperator
+{
+public:
+  explicit StokesOperator(const ::dealii::MatrixFree<dim, double>& data_)
+    : data(data_)
+  {
+  }
+
+  void
+  vmult(VectorType& dst, const VectorType& src) const
+  {
+    dst = 0.;
+    data.cell_loop(&StokesOperator::local_apply, this, dst, src);
+  }
+
+private:
+  void
+  local_apply(const ::dealii::MatrixFree<dim, double>& mf, VectorType& dst, const VectorType& src,
+              const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    FEEvaluation<dim, degree, degree + 1, dim, double> velocity(mf, 0);
+    FEEvaluation<dim, degree - 1, degree + 1, 1, double> pressure(mf, 1);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      velocity.reinit(cell);
+      velocity.read_dof_values(src.block(0));
+      velocity.evaluate(false, true);
+      pressure.reinit(cell);
+      pressure.read_dof_values(src.block(1));
+      pressure.evaluate(true, false);
+      for (unsigned int q = 0; q < velocity.n_q_points; ++q)
+      {
+        Tensor<2, dim, VectorizedArray<double>> stress = velocity.get_symmetric_gradient(q);
+        const VectorizedArray<double> p = pressure.get_value(q);
+        for (unsigned int d = 0; d < dim; ++d)
+          stress[d][d] += p;
+        pressure.submit_value(velocity.get_divergence(q), q);
+        velocity.submit_gradient(stress, q);
+      }
+      velocity.integrate(false, true);
+      velocity.distribute_local_to_global(dst.block(0));
+      pressure.integrate(true, false);
+      pressure.distribute_local_to_global(dst.block(1));
+    }
+  }
+
+  const ::dealii::MatrixFree<dim, double>& data;
+};
+
+// velocity of degree @p degree, pressure of degree @p degree - 1
+template <int dim, unsigned int degree>
+struct StokesBenchmark
+{
+  static void
+  run(const Bench::Parameters& parameters, Bench::Report& report)
+  {
+    const FE_Q<dim> fe_u_scalar(degree);
+    FESystem<dim> fe_u(fe_u_scalar, dim);
+    FE_Q<dim> fe_p(degree - 1);
+    FEData<FESystem, degree, dim, dim, 0, degree> fedata_u(fe_u);
+    FEData<FE_Q, degree - 1, 1, dim, 1, degree> fedata_p(fe_p);
+    auto fe_datas = (fedata_u, fedata_p);
+
+    TestFunction<1, dim, 0> v;
+    TestFunction<0, dim, 1> q;
+    FEFunction<1, dim, 0> u("u");
+    FEFunction<0, dim, 1> p("p");
+    FESymmetricGradient<2, dim, 0> Du(R"((\nabla+\nabla^T)u)");
+    FELiftDivergence<decltype(p)> Liftp(p);
+    auto f = form(Du + Liftp, grad(v)) + form(div(u), q);
+
+    Bench::for_each_refinement(dim, degree, dim, parameters.max_dofs, [&](unsigned int refine) {
+      parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+      GridGenerator::hyper_cube(tria);
+      tria.refine_global(refine);
+      DoFHandler<dim> dof_u(tria);
+      dof_u.distribute_dofs(fe_u);
+      DoFHandler<dim> dof_p(tria);
+      dof_p.distribute_dofs(fe_p);
+      ConstraintMatrix constraints;
+      constraints.close();
+
+      typename ::dealii::MatrixFree<dim, double>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        ::dealii::MatrixFree<dim, double>::AdditionalData::none;
+      additional_data.mapping_update_flags = update_values | update_gradients | update_JxW_values;
+      const std::vector<const DoFHandler<dim>*> dofs{ &dof_u, &dof_p };
+      const std::vector<const ConstraintMatrix*> constraints_pointers{ &constraints,
+                                                                       &constraints };
+      ::dealii::MatrixFree<dim, double> data;
+      data.reinit(dofs, constraints_pointers, QGauss<1>(degree + 1), additional_data);
+
+      MatrixFreeIntegrator<dim, VectorType, decltype(f), decltype(fe_datas)> cfl_op;
+      cfl_op.initialize(data, f, fe_datas);
+      const StokesOperator<dim, degree> hand_coded_op(data);
+
+      VectorType src(2), dst(2);
+      for (unsigned int b = 0; b < 2; ++b)
+      {
+        data.initialize_dof_vector(src.block(b), b);
+        data.initialize_dof_vector(dst.block(b), b);
+      }
+      src.collect_sizes();
+      dst.collect_sizes();
+      src = 1.;
+      report.measure(degree, refine, data, cfl_op, hand_coded_op, dst, src, parameters);
+    });
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  try
+  {
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    const Bench::Parameters parameters(argc, argv, "stokes");
+    Bench::Report report("stokes");
+    Bench::for_degrees<2, 2, 9>::run<StokesBenchmark>(parameters, report);
+    Bench::for_degrees<3, 2, 9>::run<StokesBenchmark>(parameters, report);
+    report.write(parameters.output);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
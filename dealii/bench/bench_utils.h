@@ -0,0 +1,216 @@
+#ifndef _BENCH_UTILS_H_
+#define _BENCH_UTILS_H_
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/types.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Bench
+{
+/**
+ * Command line options shared by all benchmarks:
+ *   --max-dofs N     meshes are refined as long as the problem has at most N DoFs
+ *   --repetitions N  number of vmults per timed batch
+ *   --output FILE    name of the JSON file written, cfl_bench_<name>.json by default
+ */
+struct Parameters
+{
+  Parameters(int argc, char** argv, const std::string& name)
+    : output("cfl_bench_" + name + ".json")
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string option = argv[i];
+      AssertThrow(i + 1 < argc, dealii::ExcMessage("Missing value for option " + option));
+      const std::string value = argv[++i];
+      if (option == "--max-dofs")
+        max_dofs = std::stoull(value);
+      else if (option == "--repetitions")
+        n_repetitions = std::stoul(value);
+      else if (option == "--output")
+        output = value;
+      else
+        AssertThrow(false, dealii::ExcMessage("Unknown option " + option));
+    }
+  }
+
+  dealii::types::global_dof_index max_dofs = 10000000;
+  unsigned int n_repetitions = 20;
+  std::string output;
+};
+
+/**
+ * Call @p run(refine) for all global refinements of a hyper cube, starting from one, for which
+ * a continuous element of degree @p degree with @p n_components components has at most
+ * @p max_dofs DoFs.
+ */
+template <class Run>
+void
+for_each_refinement(const int dim, const unsigned int degree, const unsigned int n_components,
+                    const dealii::types::global_dof_index max_dofs, const Run& run)
+{
+  for (unsigned int refine = 1;; ++refine)
+  {
+    const double n_dofs = n_components * std::pow(degree * (1u << refine) + 1., dim);
+    if (n_dofs > max_dofs)
+      break;
+    run(refine);
+  }
+}
+
+// static loop over the polynomial degrees from, ..., to-1 for the Benchmark<dim, degree>
+template <int dim, unsigned int from, unsigned int to>
+struct for_degrees
+{
+  template <template <int, unsigned int> class Benchmark, class Report>
+  static void
+  run(const Parameters& parameters, Report& report)
+  {
+    Benchmark<dim, from>::run(parameters, report);
+    for_degrees<dim, from + 1, to>::template run<Benchmark>(parameters, report);
+  }
+};
+
+template <int dim, unsigned int to>
+struct for_degrees<dim, to, to>
+{
+  template <template <int, unsigned int> class Benchmark, class Report>
+  static void
+  run(const Parameters& /*parameters*/, Report& /*report*/)
+  {
+  }
+};
+
+/**
+ * The wall time of a single vmult of @p op, the minimum over five batches of
+ * @p n_repetitions vmults each after one warm-up vmult. With MPI the slowest process counts.
+ */
+template <class Operator, class VectorType>
+double
+time_vmult(const Operator& op, VectorType& dst, const VectorType& src,
+           const unsigned int n_repetitions)
+{
+  op.vmult(dst, src);
+  double best_time = std::numeric_limits<double>::max();
+  for (unsigned int batch = 0; batch < 5; ++batch)
+  {
+    MPI_Barrier(MPI_COMM_WORLD);
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n_repetitions; ++i)
+      op.vmult(dst, src);
+    const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    best_time = std::min(
+      best_time, dealii::Utilities::MPI::max(time.count() / n_repetitions, MPI_COMM_WORLD));
+  }
+  return best_time;
+}
+
+/**
+ * Collects the timings of a CFL operator and the equivalent hand-written FEEvaluation
+ * operator for all degrees and meshes and writes them as JSON. Benchmarks comparing two other
+ * variants name them by @p first_label and @p second_label.
+ */
+class Report
+{
+public:
+  explicit Report(std::string name_, std::string first_label_ = "cfl",
+                  std::string second_label_ = "hand_coded")
+    : name(std::move(name_))
+    , first_label(std::move(first_label_))
+    , second_label(std::move(second_label_))
+  {
+  }
+
+  /**
+   * Time @p cfl_op and @p hand_coded_op on the vectors @p dst and @p src. The memory
+   * traffic of a vmult is estimated by reading @p src and reading and writing @p dst once, plus
+   * streaming all data of @p data. DoFs, cells and memory are counted over all processes: the
+   * size of the distributed vector @p src is global, and the locally owned cells of @p data
+   * must add up to the cells of a distributed triangulation.
+   */
+  template <int dim, typename Number, class CFLOperator, class HandCodedOperator,
+            class VectorType>
+  void
+  measure(const unsigned int degree, const unsigned int refine,
+          const dealii::MatrixFree<dim, Number>& data, const CFLOperator& cfl_op,
+          const HandCodedOperator& hand_coded_op, VectorType& dst, const VectorType& src,
+          const Parameters& parameters)
+  {
+    Entry entry;
+    entry.dim = dim;
+    entry.degree = degree;
+    entry.refine = refine;
+    entry.n_dofs = src.size();
+    entry.n_cells = dealii::Utilities::MPI::sum(data.n_physical_cells(), MPI_COMM_WORLD);
+    AssertThrow(entry.n_cells == data.get_dof_handler().get_triangulation().n_global_active_cells(),
+                dealii::ExcMessage("The processes do not partition the mesh, use a "
+                                   "parallel::distributed::Triangulation!"));
+    entry.bytes = 3. * sizeof(Number) * entry.n_dofs +
+                  dealii::Utilities::MPI::sum(1. * data.memory_consumption(), MPI_COMM_WORLD);
+    entry.cfl_time = time_vmult(cfl_op, dst, src, parameters.n_repetitions);
+    entry.hand_coded_time = time_vmult(hand_coded_op, dst, src, parameters.n_repetitions);
+    entries.push_back(entry);
+  }
+
+  void
+  write(const std::string& filename) const
+  {
+    if (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) != 0)
+      return;
+    std::ofstream out(filename);
+    AssertThrow(out, dealii::ExcIO());
+    out << "{\n  \"benchmark\": \"" << name << "\",\n  \"n_mpi_processes\": "
+        << dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD) << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      const Entry& entry = entries[i];
+      out << (i > 0 ? "," : "") << "\n    {\"dim\": " << entry.dim
+          << ", \"degree\": " << entry.degree << ", \"refine\": " << entry.refine
+          << ", \"n_dofs\": " << entry.n_dofs << ", \"n_cells\": " << entry.n_cells
+          << ",\n     \"" << first_label << "\": ";
+      write_timing(out, entry, entry.cfl_time);
+      out << ",\n     \"" << second_label << "\": ";
+      write_timing(out, entry, entry.hand_coded_time);
+      out << ",\n     \"overhead\": " << entry.cfl_time / entry.hand_coded_time << "}";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+private:
+  struct Entry
+  {
+    int dim;
+    unsigned int degree;
+    unsigned int refine;
+    dealii::types::global_dof_index n_dofs;
+    unsigned int n_cells;
+    double bytes;
+    double cfl_time;
+    double hand_coded_time;
+  };
+
+  static void
+  write_timing(std::ostream& out, const Entry& entry, const double time)
+  {
+    out << "{\"time\": " << time << ", \"dofs_per_second\": " << entry.n_dofs / time
+        << ", \"gb_per_second\": " << 1.e-9 * entry.bytes / time << "}";
+  }
+
+  const std::string name;
+  const std::string first_label;
+  const std::string second_label;
+  std::vector<Entry> entries;
+};
+} // namespace Bench
+
+#endif
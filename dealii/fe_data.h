@@ -3,12 +3,31 @@
 
 #include <cfl/dealii_matrixfree.h>
 #include <cfl/traits.h>
+#include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/matrix_free/matrix_free.h>
+#include <dealii/phase_counters.h>
+
+#include <algorithm>
+#include <array>
 
 template <typename... Types>
 class FEDatas;
 
+/**
+ * The values of a Coefficient cached by MatrixFreeIntegratorBase::cache_coefficient() in all
+ * quadrature points of the cell batches of one MatrixFree object, n_values_per_cell entries per
+ * cell batch, see FEDatas::get_coefficient_values().
+ */
+template <typename Number>
+struct CoefficientValues
+{
+  // Coefficient::get_id() of the Coefficient the values belong to
+  unsigned int id;
+  unsigned int n_values_per_cell;
+  dealii::AlignedVector<dealii::VectorizedArray<Number>> values;
+};
+
 template <template <int, int> class FiniteElementType, int fe_degree, int n_components, int dim,
           unsigned int fe_no, unsigned int max_fe_degree, typename Number = double>
 class FEData final
@@ -16,10 +35,16 @@ class FEData final
 public:
   using FEEvaluationType =
     typename dealii::FEEvaluation<dim, fe_degree, max_fe_degree + 1, n_components, Number>;
+  using FEFaceEvaluationType =
+    typename dealii::FEFaceEvaluation<dim, fe_degree, max_fe_degree + 1, n_components, Number>;
   using NumberType = Number;
   using TensorTraits = CFL::Traits::Tensor<(n_components > 1 ? 1 : 0), dim>;
   static constexpr unsigned int fe_number = fe_no;
   static constexpr unsigned int max_degree = max_fe_degree;
+  static constexpr unsigned int degree = fe_degree;
+  static constexpr unsigned int n_q_points_1d = max_fe_degree + 1;
+  static constexpr unsigned int n_fe_components = n_components;
+  static constexpr int dimension = dim;
   const std::shared_ptr<const FiniteElementType<dim, dim>> fe;
 
   explicit FEData(const FiniteElementType<dim, dim>& fe_)
@@ -36,6 +61,113 @@ public:
                 dealii::ExcDimensionMismatch(fe->n_components(), n_components));
   }
 
+  /**
+   * Number of VectorizedArray entries needed to store the values and/or gradients of all
+   * components in all quadrature points of a cell batch, see store_quadrature_data().
+   */
+  static constexpr unsigned int
+  n_quadrature_data(const bool values, const bool gradients)
+  {
+    return ((values ? 1 : 0) + (gradients ? dim : 0)) * n_components *
+           FEEvaluationType::static_n_q_points;
+  }
+
+  /**
+   * Copy the values and/or gradients in the quadrature points of @p phi to @p data, in the
+   * layout of FEEvaluation::begin_values() followed by FEEvaluation::begin_gradients(). The
+   * gradients are stored in real coordinates as returned by FEEvaluation::get_gradient(), not
+   * the reference cell gradients of begin_gradients(), so @p phi must be reinitialized on the
+   * cell batch that was evaluated.
+   */
+  static void
+  store_quadrature_data(const FEEvaluationType& phi, const bool values, const bool gradients,
+                        dealii::VectorizedArray<Number>* data)
+  {
+    constexpr unsigned int n_q_points = FEEvaluationType::static_n_q_points;
+    if (values)
+      data = std::copy_n(phi.begin_values(), n_components * n_q_points, data);
+    if (gradients)
+      for (unsigned int q = 0; q < n_q_points; ++q)
+      {
+        const auto gradient = phi.get_gradient(q);
+        for (unsigned int d = 0; d < dim; ++d)
+          if constexpr(n_components == 1)
+            data[d * n_q_points + q] = gradient[d];
+          else
+            for (unsigned int c = 0; c < n_components; ++c)
+              data[(c * dim + d) * n_q_points + q] = gradient[c][d];
+      }
+  }
+
+  static typename FEEvaluationType::value_type
+  get_stored_value(const dealii::VectorizedArray<Number>* data, const unsigned int q)
+  {
+    constexpr unsigned int n_q_points = FEEvaluationType::static_n_q_points;
+    if constexpr(n_components == 1)
+      return data[q];
+    else
+    {
+      typename FEEvaluationType::value_type value;
+      for (unsigned int c = 0; c < n_components; ++c)
+        value[c] = data[c * n_q_points + q];
+      return value;
+    }
+  }
+
+  static typename FEEvaluationType::gradient_type
+  get_stored_gradient(const dealii::VectorizedArray<Number>* data, const bool values,
+                      const unsigned int q)
+  {
+    constexpr unsigned int n_q_points = FEEvaluationType::static_n_q_points;
+    const dealii::VectorizedArray<Number>* gradients =
+      data + (values ? n_components * n_q_points : 0);
+    typename FEEvaluationType::gradient_type gradient;
+    for (unsigned int d = 0; d < dim; ++d)
+      if constexpr(n_components == 1)
+        gradient[d] = gradients[d * n_q_points + q];
+      else
+        for (unsigned int c = 0; c < n_components; ++c)
+          gradient[c][d] = gradients[(c * dim + d) * n_q_points + q];
+    return gradient;
+  }
+
+  /**
+   * The values (or, if @p gradient is true, the gradients) submitted to @p phi in quadrature
+   * point @p q, see add_submitted().
+   */
+  template <bool gradient, class FEEvaluation>
+  static std::array<dealii::VectorizedArray<Number>, n_components*(gradient ? dim : 1)>
+  get_submitted(const FEEvaluation& phi, const unsigned int q)
+  {
+    constexpr unsigned int n_q_points = FEEvaluation::static_n_q_points;
+    const dealii::VectorizedArray<Number>* data =
+      gradient ? phi.begin_gradients() : phi.begin_values();
+    std::array<dealii::VectorizedArray<Number>, n_components*(gradient ? dim : 1)> submitted;
+    for (unsigned int i = 0; i < submitted.size(); ++i)
+      submitted[i] = data[i * n_q_points + q];
+    return submitted;
+  }
+
+  /**
+   * Add @p submitted, obtained from get_submitted(), to the data submitted to @p phi in
+   * quadrature point @p q. The submitted data is linear in the submitted value, so this is the
+   * same as submitting the sum of both values.
+   */
+  template <bool gradient, class FEEvaluation>
+  static void
+  add_submitted(
+    FEEvaluation& phi,
+    const std::array<dealii::VectorizedArray<Number>, n_components*(gradient ? dim : 1)>&
+      submitted,
+    const unsigned int q)
+  {
+    constexpr unsigned int n_q_points = FEEvaluation::static_n_q_points;
+    dealii::VectorizedArray<Number>* data =
+      gradient ? phi.begin_gradients() : phi.begin_values();
+    for (unsigned int i = 0; i < submitted.size(); ++i)
+      data[i * n_q_points + q] += submitted[i];
+  }
+
   // for (feData,feData)
   template <class FEDataOther>
   typename std::enable_if_t<CFL::Traits::is_fe_data<FEDataOther>::value,
@@ -120,6 +252,71 @@ public:
 #endif
     Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
     fe_evaluation->reinit(cell);
+    if constexpr(std::is_integral<Cell>::value)
+        cell_index = cell;
+  }
+
+  // the cell batch passed to the last call of reinit()
+  unsigned int
+  get_cell_index() const
+  {
+    return cell_index;
+  }
+
+  // the quadrature points of the current cell batch, needs update_quadrature_points
+  auto
+  get_quadrature_point(unsigned int q) const
+  {
+    Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+    return fe_evaluation->quadrature_point(q);
+  }
+
+  /**
+   * Let get_cell_parameter() read from @p parameters, which holds @p n_parameters values for
+   * each cell batch one after the other.
+   */
+  void
+  set_cell_parameters(const dealii::VectorizedArray<NumberType>* parameters,
+                      const unsigned int n_parameters)
+  {
+    cell_parameters = parameters;
+    n_cell_parameters = n_parameters;
+  }
+
+  // the parameter @p index of the current cell batch, see set_cell_parameters()
+  template <unsigned int index>
+  const dealii::VectorizedArray<NumberType>&
+  get_cell_parameter() const
+  {
+    Assert(cell_parameters != nullptr, dealii::ExcMessage("No cell parameters set!"));
+    AssertIndexRange(index, n_cell_parameters);
+    return cell_parameters[cell_index * n_cell_parameters + index];
+  }
+
+  // Let get_coefficient_values() read from @p values, e.g. the ones of an operator.
+  void
+  set_coefficient_values(const std::vector<CoefficientValues<NumberType>>* values)
+  {
+    coefficient_values = values;
+  }
+
+  /**
+   * The cached values of the Coefficient with the id @p id on the current cell batch, see
+   * set_coefficient_values(), or nullptr if they are not cached. Then the Coefficient calls its
+   * function instead.
+   */
+  const dealii::VectorizedArray<NumberType>*
+  get_coefficient_values(const unsigned int id) const
+  {
+    if (coefficient_values != nullptr)
+      for (const auto& coefficient : *coefficient_values)
+        if (coefficient.id == id)
+        {
+          Assert((cell_index + 1) * coefficient.n_values_per_cell <= coefficient.values.size(),
+                 dealii::ExcInternalError());
+          return coefficient.values.begin() + cell_index * coefficient.n_values_per_cell;
+        }
+    return nullptr;
   }
 
   template <typename VectorType>
@@ -130,7 +327,12 @@ public:
     std::cout << "Read DoF values " << fe_number << std::endl;
 #endif
     Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
-    if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+    if (quadrature_data != nullptr)
+      return;
+    const PhaseTimer timer(phase_counters, fe_number, Phase::read_dof_values);
+    if (bound_vector != nullptr)
+      fe_evaluation->read_dof_values(*bound_vector);
+    else if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
         fe_evaluation->read_dof_values(vector.block(fe_number));
     else
       fe_evaluation->read_dof_values(vector);
@@ -171,6 +373,7 @@ public:
       std::cout << "Distribute DoF values " << fe_number << std::endl;
 #endif
       Assert(fe_evaluation.get() != nullptr, dealii::ExcInternalError());
+      const PhaseTimer timer(phase_counters, fe_number, Phase::distribute_local_to_global);
       if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
           fe_evaluation->distribute_local_to_global(vector.block(fe_number));
       else
@@ -201,7 +404,11 @@ public:
               << evaluate_gradients << " " << evaluate_hessians << std::endl;
 #endif
     Assert(fe_evaluation.get() != nullptr, dealii::ExcInternalError());
-    fe_evaluation->evaluate(evaluate_values, evaluate_gradients, evaluate_hessians);
+    if (quadrature_data == nullptr)
+    {
+      const PhaseTimer timer(phase_counters, fe_number, Phase::evaluate);
+      fe_evaluation->evaluate(evaluate_values, evaluate_gradients, evaluate_hessians);
+    }
   }
 
   template <unsigned int fe_number_extern = fe_number>
@@ -220,6 +427,8 @@ public:
     std::cout << "get gradient FEDatas " << fe_number << " " << q << std::endl;
 #endif
     static_assert(fe_number == fe_number_extern, "Component not found!");
+    if (quadrature_data != nullptr)
+      return FEData::get_stored_gradient(quadrature_data, evaluate_values, q);
     return fe_evaluation->get_gradient(q);
   }
 
@@ -231,6 +440,7 @@ public:
     std::cout << "get symmetric gradient FEDatas " << fe_number << " " << q << std::endl;
 #endif
     static_assert(fe_number == fe_number_extern, "Component not found!");
+    Assert(quadrature_data == nullptr, dealii::ExcNotImplemented());
     return fe_evaluation->get_symmetric_gradient(q);
   }
 
@@ -242,6 +452,7 @@ public:
     std::cout << "get divergence FEDatas " << fe_number << " " << q << std::endl;
 #endif
     static_assert(fe_number == fe_number_extern, "Component not found!");
+    Assert(quadrature_data == nullptr, dealii::ExcNotImplemented());
     return fe_evaluation->get_divergence(q);
   }
 
@@ -286,6 +497,8 @@ public:
     std::cout << "get value FEDatas " << fe_number << " " << q << std::endl;
 #endif
     static_assert(fe_number == fe_number_extern, "Component not found!");
+    if (quadrature_data != nullptr)
+      return FEData::get_stored_value(quadrature_data, q);
     return fe_evaluation->get_value(q);
   }
 
@@ -359,6 +572,26 @@ public:
     fe_evaluation->submit_value(value, q);
   }
 
+  /**
+   * The data submitted to the values or gradients of block @p fe_number_extern in quadrature
+   * point @p q, see Form::submit_add().
+   */
+  template <unsigned int fe_number_extern, bool gradient>
+  auto
+  get_submitted(unsigned int q) const
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    return FEData::template get_submitted<gradient>(*fe_evaluation, q);
+  }
+
+  template <unsigned int fe_number_extern, bool gradient, typename SubmittedType>
+  void
+  add_submitted(const SubmittedType& submitted, unsigned int q)
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    FEData::template add_submitted<gradient>(*fe_evaluation, submitted, q);
+  }
+
   void
   integrate()
   {
@@ -367,7 +600,10 @@ public:
               << integrate_gradients << std::endl;
 #endif
     if (integrate_values | integrate_gradients)
+    {
+      const PhaseTimer timer(phase_counters, fe_number, Phase::integrate);
       fe_evaluation->integrate(integrate_values, integrate_gradients);
+    }
   }
 
   template <unsigned int fe_number_extern>
@@ -402,6 +638,118 @@ public:
     return fe_evaluation->begin_dof_values();
   }
 
+  template <unsigned int fe_number_extern>
+  auto&
+  get_fe_evaluation() const
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+    return *fe_evaluation;
+  }
+
+  template <unsigned int fe_number_extern>
+  std::array<bool, 3>
+  get_evaluation_flags() const
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    return { { evaluate_values, evaluate_gradients, evaluate_hessians } };
+  }
+
+  template <unsigned int fe_number_extern>
+  std::array<bool, 2>
+  get_integration_flags() const
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    return { { integrate_values, integrate_gradients } };
+  }
+
+  // Set all DoF values of the given block to zero, e.g. before probing the operator.
+  template <unsigned int fe_number_extern>
+  void
+  set_dof_values_to_zero()
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+    const auto zero = typename FEData::FEEvaluationType::value_type();
+    for (unsigned int i = 0; i < fe_evaluation->dofs_per_component; ++i)
+      fe_evaluation->submit_dof_value(zero, i);
+  }
+
+  /**
+   * Make get_value() and get_gradient() of the given block return the quadrature point data
+   * stored at @p data by store_quadrature_data(), e.g. for a cell batch evaluated earlier.
+   * The block is then skipped by read_dof_values() and evaluate(). Pass nullptr to switch
+   * back to evaluating the DoF values.
+   */
+  template <unsigned int fe_number_extern>
+  void
+  set_quadrature_data(const dealii::VectorizedArray<NumberType>* data)
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    quadrature_data = data;
+  }
+
+  /**
+   * Let read_dof_values() read the given block from @p vector instead of the corresponding
+   * block of its argument, without copying. Pass nullptr to remove the binding.
+   */
+  template <unsigned int fe_number_extern>
+  void
+  bind_dof_values(const dealii::LinearAlgebra::distributed::Vector<NumberType>* vector)
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    bound_vector = vector;
+  }
+
+  /**
+   * Accumulate the cycles spent by all blocks in the phases of the cell loop in @p counters,
+   * which needs a row for each fe_number. Only has an effect if PHASE_COUNTERS is defined,
+   * pass nullptr to stop counting.
+   */
+  void
+  set_phase_counters(PhaseCounters* counters)
+  {
+    phase_counters = counters;
+  }
+
+  PhaseCounters*
+  get_phase_counters() const
+  {
+    return phase_counters;
+  }
+
+  // Read the DoF values of the given block from its bound vector, false if there is none.
+  template <unsigned int fe_number_extern>
+  bool
+  read_bound_dof_values()
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+    if (bound_vector == nullptr)
+      return false;
+    fe_evaluation->read_dof_values(*bound_vector);
+    return true;
+  }
+
+  // Store the evaluated values and gradients of the given block at @p data.
+  template <unsigned int fe_number_extern>
+  void
+  store_quadrature_data(dealii::VectorizedArray<NumberType>* data) const
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+    FEData::store_quadrature_data(*fe_evaluation, evaluate_values, evaluate_gradients, data);
+  }
+
+  // The size of the data stored by store_quadrature_data(), zero if it cannot be stored.
+  template <unsigned int fe_number_extern>
+  unsigned int
+  n_quadrature_data() const
+  {
+    static_assert(fe_number == fe_number_extern, "Component not found!");
+    return evaluate_hessians ? 0 : FEData::n_quadrature_data(evaluate_values, evaluate_gradients);
+  }
+
 protected:
   const FEData fe_data;
 
@@ -420,6 +768,18 @@ private:
   bool evaluate_gradients = false;
   bool evaluate_hessians = false;
   bool initialized = false;
+  // stored quadrature point data replacing the evaluation, see set_quadrature_data()
+  const dealii::VectorizedArray<NumberType>* quadrature_data = nullptr;
+  // the vector to read the DoF values from instead, see bind_dof_values()
+  const dealii::LinearAlgebra::distributed::Vector<NumberType>* bound_vector = nullptr;
+  // where the cycles of each phase are accumulated, see set_phase_counters()
+  PhaseCounters* phase_counters = nullptr;
+  unsigned int cell_index = dealii::numbers::invalid_unsigned_int;
+  // the parameters of all cell batches, see set_cell_parameters()
+  const dealii::VectorizedArray<NumberType>* cell_parameters = nullptr;
+  unsigned int n_cell_parameters = 0;
+  // the cached Coefficient values of all cell batches, see set_coefficient_values()
+  const std::vector<CoefficientValues<NumberType>>* coefficient_values = nullptr;
 };
 
 template <class FEData, typename... Types>
@@ -504,7 +864,12 @@ public:
         std::cout << "Read DoF values " << fe_number << std::endl;
 #endif
         Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
-        fe_evaluation->read_dof_values(vector.block(fe_number));
+        if (quadrature_data == nullptr)
+        {
+          const PhaseTimer timer(phase_counters, fe_number, Phase::read_dof_values);
+          fe_evaluation->read_dof_values(bound_vector != nullptr ? *bound_vector
+                                                                 : vector.block(fe_number));
+        }
         Base::read_dof_values(vector);
       }
     else
@@ -529,6 +894,7 @@ public:
           std::cout << "Distribute DoF values " << fe_number << std::endl;
 #endif
           Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+          const PhaseTimer timer(phase_counters, fe_number, Phase::distribute_local_to_global);
           fe_evaluation->distribute_local_to_global(vector.block(fe_number));
         }
         Base::distribute_local_to_global(vector);
@@ -551,7 +917,11 @@ public:
               << evaluate_gradients << " " << evaluate_hessians << std::endl;
 #endif
     Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
-    fe_evaluation->evaluate(evaluate_values, evaluate_gradients, evaluate_hessians);
+    if (quadrature_data == nullptr)
+    {
+      const PhaseTimer timer(phase_counters, fe_number, Phase::evaluate);
+      fe_evaluation->evaluate(evaluate_values, evaluate_gradients, evaluate_hessians);
+    }
     Base::evaluate();
   }
 
@@ -563,7 +933,10 @@ public:
               << integrate_gradients << std::endl;
 #endif
     if (integrate_values | integrate_gradients)
+    {
+      const PhaseTimer timer(phase_counters, fe_number, Phase::integrate);
       fe_evaluation->integrate(integrate_values, integrate_gradients);
+    }
     Base::integrate();
   }
 
@@ -621,6 +994,8 @@ public:
 #ifdef DEBUG_OUTPUT
         std::cout << "get gradient FEDatas " << fe_number << " " << q << std::endl;
 #endif
+        if (quadrature_data != nullptr)
+          return FEData::get_stored_gradient(quadrature_data, evaluate_values, q);
         return fe_evaluation->get_gradient(q);
       }
     else
@@ -636,6 +1011,7 @@ public:
 #ifdef DEBUG_OUTPUT
         std::cout << "get symmetric gradient FEDatas " << fe_number << " " << q << std::endl;
 #endif
+        Assert(quadrature_data == nullptr, dealii::ExcNotImplemented());
         return fe_evaluation->get_symmetric_gradient(q);
       }
     else
@@ -651,6 +1027,7 @@ public:
 #ifdef DEBUG_OUTPUT
         std::cout << "get divergence FEDatas " << fe_number << " " << q << std::endl;
 #endif
+        Assert(quadrature_data == nullptr, dealii::ExcNotImplemented());
         return fe_evaluation->get_divergence(q);
       }
     else
@@ -711,6 +1088,8 @@ public:
 #ifdef DEBUG_OUTPUT
         std::cout << "get value FEDatas " << fe_number << " " << q << std::endl;
 #endif
+        if (quadrature_data != nullptr)
+          return FEData::get_stored_value(quadrature_data, q);
         return fe_evaluation->get_value(q);
       }
     else
@@ -779,6 +1158,26 @@ public:
       Base::template submit_value<fe_number_extern, ValueType>(value, q);
   }
 
+  template <unsigned int fe_number_extern, bool gradient>
+  auto
+  get_submitted(unsigned int q) const
+  {
+    if constexpr(fe_number == fe_number_extern)
+      return FEData::template get_submitted<gradient>(*fe_evaluation, q);
+    else
+      return Base::template get_submitted<fe_number_extern, gradient>(q);
+  }
+
+  template <unsigned int fe_number_extern, bool gradient, typename SubmittedType>
+  void
+  add_submitted(const SubmittedType& submitted, unsigned int q)
+  {
+    if constexpr(fe_number == fe_number_extern)
+      FEData::template add_submitted<gradient>(*fe_evaluation, submitted, q);
+    else
+      Base::template add_submitted<fe_number_extern, gradient>(submitted, q);
+  }
+
   template <unsigned int fe_number_extern>
   const auto&
   get_fe_data() const
@@ -816,6 +1215,131 @@ public:
       return Base::template begin_dof_values<fe_number_extern>();
   }
 
+  template <unsigned int fe_number_extern>
+  auto&
+  get_fe_evaluation() const
+  {
+    if constexpr(fe_number == fe_number_extern)
+      {
+        Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+        return *fe_evaluation;
+      }
+    else
+      return Base::template get_fe_evaluation<fe_number_extern>();
+  }
+
+  template <unsigned int fe_number_extern>
+  std::array<bool, 3>
+  get_evaluation_flags() const
+  {
+    if constexpr(fe_number == fe_number_extern)
+      {
+        return { { evaluate_values, evaluate_gradients, evaluate_hessians } };
+      }
+    else
+      return Base::template get_evaluation_flags<fe_number_extern>();
+  }
+
+  template <unsigned int fe_number_extern>
+  std::array<bool, 2>
+  get_integration_flags() const
+  {
+    if constexpr(fe_number == fe_number_extern)
+      {
+        return { { integrate_values, integrate_gradients } };
+      }
+    else
+      return Base::template get_integration_flags<fe_number_extern>();
+  }
+
+  template <unsigned int fe_number_extern>
+  void
+  set_dof_values_to_zero()
+  {
+    if constexpr(fe_number == fe_number_extern)
+      {
+        Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+        const auto zero = typename FEData::FEEvaluationType::value_type();
+        for (unsigned int i = 0; i < fe_evaluation->dofs_per_component; ++i)
+          fe_evaluation->submit_dof_value(zero, i);
+      }
+    else
+      Base::template set_dof_values_to_zero<fe_number_extern>();
+  }
+
+  template <unsigned int fe_number_extern>
+  void
+  set_quadrature_data(const dealii::VectorizedArray<NumberType>* data)
+  {
+    if constexpr(fe_number == fe_number_extern)
+      quadrature_data = data;
+    else
+      Base::template set_quadrature_data<fe_number_extern>(data);
+  }
+
+  template <unsigned int fe_number_extern>
+  void
+  bind_dof_values(const dealii::LinearAlgebra::distributed::Vector<NumberType>* vector)
+  {
+    if constexpr(fe_number == fe_number_extern)
+      bound_vector = vector;
+    else
+      Base::template bind_dof_values<fe_number_extern>(vector);
+  }
+
+  void
+  set_phase_counters(PhaseCounters* counters)
+  {
+    phase_counters = counters;
+    Base::set_phase_counters(counters);
+  }
+
+  PhaseCounters*
+  get_phase_counters() const
+  {
+    return phase_counters;
+  }
+
+  template <unsigned int fe_number_extern>
+  bool
+  read_bound_dof_values()
+  {
+    if constexpr(fe_number == fe_number_extern)
+      {
+        Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+        if (bound_vector == nullptr)
+          return false;
+        fe_evaluation->read_dof_values(*bound_vector);
+        return true;
+      }
+    else
+      return Base::template read_bound_dof_values<fe_number_extern>();
+  }
+
+  template <unsigned int fe_number_extern>
+  void
+  store_quadrature_data(dealii::VectorizedArray<NumberType>* data) const
+  {
+    if constexpr(fe_number == fe_number_extern)
+      {
+        Assert(fe_evaluation != nullptr, dealii::ExcInternalError());
+        FEData::store_quadrature_data(*fe_evaluation, evaluate_values, evaluate_gradients, data);
+      }
+    else
+      Base::template store_quadrature_data<fe_number_extern>(data);
+  }
+
+  template <unsigned int fe_number_extern>
+  unsigned int
+  n_quadrature_data() const
+  {
+    if constexpr(fe_number == fe_number_extern)
+      return evaluate_hessians ? 0
+                               : FEData::n_quadrature_data(evaluate_values, evaluate_gradients);
+    else
+      return Base::template n_quadrature_data<fe_number_extern>();
+  }
+
   template <class FEDataOther>
   typename std::enable_if_t<CFL::Traits::is_fe_data<FEDataOther>::value,
                             FEDatas<FEDataOther, FEData, Types...>>
@@ -843,6 +1367,12 @@ private:
   bool evaluate_gradients = false;
   bool evaluate_hessians = false;
   bool initialized = false;
+  // stored quadrature point data replacing the evaluation, see set_quadrature_data()
+  const dealii::VectorizedArray<NumberType>* quadrature_data = nullptr;
+  // the vector to read the DoF values from instead, see bind_dof_values()
+  const dealii::LinearAlgebra::distributed::Vector<NumberType>* bound_vector = nullptr;
+  // where the cycles of each phase are accumulated, see set_phase_counters()
+  PhaseCounters* phase_counters = nullptr;
 };
 
 #endif // FE_DATA_H
@@ -0,0 +1,441 @@
+#ifndef FE_FACE_DATA_H
+#define FE_FACE_DATA_H
+
+#include <cfl/static_for.h>
+#include <cfl/traits.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <array>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+/**
+ * The counterpart of FEDatas on faces. For every block of @p FEDatasType it holds
+ * FEFaceEvaluation objects for both sides of a face if @p domain is
+ * CFL::IntegrationDomain::face, and for the interior side only if @p domain is
+ * CFL::IntegrationDomain::boundary. Forms are only evaluated with it if their test functions
+ * live on the same domain, see CFL::Form::is_evaluated_by.
+ *
+ * On interior faces, the jump is u^- - u^+ with u^- the value on the interior cell. Normal
+ * derivatives on both sides are taken with respect to the normal vector pointing out of the
+ * interior cell.
+ */
+template <class FEDatasType, CFL::IntegrationDomain domain>
+class FEFaceDatas
+{
+public:
+  static_assert(domain != CFL::IntegrationDomain::cell, "Use FEDatas on cells!");
+
+  using NumberType = typename FEDatasType::NumberType;
+  static constexpr CFL::IntegrationDomain integration_domain = domain;
+  static constexpr unsigned int n = FEDatasType::n;
+  static constexpr unsigned int max_degree = FEDatasType::max_degree;
+  static constexpr unsigned int n_sides = (domain == CFL::IntegrationDomain::face) ? 2 : 1;
+
+  template <unsigned int fe_number>
+  using FEData =
+    std::decay_t<decltype(std::declval<FEDatasType>().template get_fe_data<fe_number>())>;
+
+  template <unsigned int fe_number>
+  using FEFaceEvaluationType = typename FEData<fe_number>::FEFaceEvaluationType;
+
+  template <unsigned int fe_number>
+  static constexpr unsigned int
+  rank()
+  {
+    return FEData<fe_number>::TensorTraits::rank;
+  }
+
+  template <unsigned int fe_number = 0>
+  static constexpr unsigned int
+  get_n_q_points()
+  {
+    return FEFaceEvaluationType<fe_number>::static_n_q_points;
+  }
+
+  template <unsigned int fe_number>
+  void
+  set_evaluation_flags(bool evaluate_value, bool evaluate_gradient)
+  {
+    get_block<fe_number>().evaluate_values |= evaluate_value;
+    get_block<fe_number>().evaluate_gradients |= evaluate_gradient;
+  }
+
+  template <unsigned int fe_number>
+  void
+  set_integration_flags(bool integrate_value, bool integrate_gradient)
+  {
+    get_block<fe_number>().integrate_values |= integrate_value;
+    get_block<fe_number>().integrate_gradients |= integrate_gradient;
+  }
+
+  template <unsigned int fe_number>
+  std::array<bool, 2>
+  get_evaluation_flags() const
+  {
+    const auto& block = get_block<fe_number>();
+    return { { block.evaluate_values, block.evaluate_gradients } };
+  }
+
+  template <unsigned int fe_number>
+  std::array<bool, 2>
+  get_integration_flags() const
+  {
+    const auto& block = get_block<fe_number>();
+    return { { block.integrate_values, block.integrate_gradients } };
+  }
+
+  /**
+   * Create the FEFaceEvaluation objects for all blocks used by the forms. Like
+   * FEDatas::initialize, this has to be called after the flags have been set.
+   */
+  template <int dim, typename OtherNumber>
+  void
+  initialize(const dealii::MatrixFree<dim, OtherNumber>& mf)
+  {
+    static_assert(std::is_same<NumberType, OtherNumber>::value,
+                  "Number type of MatrixFree and FEFaceDatas has to match!");
+    static_for_each<n>([&](auto fe_number) {
+      constexpr unsigned int b = decltype(fe_number)::value;
+      auto& block = get_block<b>();
+      for (unsigned int side = 0; side < n_sides; ++side)
+        block.fe_evaluation[side] =
+          block.is_used() ? std::make_shared<FEFaceEvaluationType<b>>(mf, side == 0, b) : nullptr;
+    });
+  }
+
+  void
+  reinit(const unsigned int face)
+  {
+    for_each_used_side([&](auto& fe_evaluation, const auto& /*block*/) {
+      fe_evaluation.reinit(face);
+    });
+    face_index = face;
+  }
+
+  /**
+   * Let get_cell_parameter() read from @p parameters, which holds @p n_parameters values for
+   * each face batch one after the other, see FEDatas::set_cell_parameters().
+   */
+  void
+  set_cell_parameters(const dealii::VectorizedArray<NumberType>* parameters,
+                      const unsigned int n_parameters)
+  {
+    cell_parameters = parameters;
+    n_cell_parameters = n_parameters;
+  }
+
+  // the parameter @p index of the cells adjacent to the current face batch
+  template <unsigned int index>
+  const dealii::VectorizedArray<NumberType>&
+  get_cell_parameter() const
+  {
+    Assert(cell_parameters != nullptr, dealii::ExcMessage("No cell parameters set!"));
+    AssertIndexRange(index, n_cell_parameters);
+    return cell_parameters[face_index * n_cell_parameters + index];
+  }
+
+  template <typename VectorType>
+  void
+  read_dof_values(const VectorType& vector)
+  {
+    static_for_each<n>([&](auto fe_number) {
+      constexpr unsigned int b = decltype(fe_number)::value;
+      auto& block = get_block<b>();
+      if (!(block.evaluate_values || block.evaluate_gradients))
+        return;
+      for (unsigned int side = 0; side < n_sides; ++side)
+      {
+        if (block.bound_vector != nullptr)
+          block.fe_evaluation[side]->read_dof_values(*block.bound_vector);
+        else if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+            block.fe_evaluation[side]->read_dof_values(vector.block(b));
+        else
+        {
+          static_assert(n == 1, "Multiple blocks need a block vector!");
+          block.fe_evaluation[side]->read_dof_values(vector);
+        }
+      }
+    });
+  }
+
+  // see FEDatas::bind_dof_values
+  template <unsigned int fe_number>
+  void
+  bind_dof_values(const dealii::LinearAlgebra::distributed::Vector<NumberType>* vector)
+  {
+    get_block<fe_number>().bound_vector = vector;
+  }
+
+  // see FEDatas::read_bound_dof_values
+  template <unsigned int fe_number>
+  bool
+  read_bound_dof_values()
+  {
+    auto& block = get_block<fe_number>();
+    if (block.bound_vector == nullptr)
+      return false;
+    for (const auto& fe_evaluation : block.fe_evaluation)
+      if (fe_evaluation != nullptr)
+        fe_evaluation->read_dof_values(*block.bound_vector);
+    return true;
+  }
+
+  void
+  evaluate()
+  {
+    for_each_used_side([&](auto& fe_evaluation, const auto& block) {
+      if (block.evaluate_values || block.evaluate_gradients)
+        fe_evaluation.evaluate(block.evaluate_values, block.evaluate_gradients);
+    });
+  }
+
+  void
+  integrate()
+  {
+    for_each_used_side([&](auto& fe_evaluation, const auto& block) {
+      if (block.integrate_values || block.integrate_gradients)
+        fe_evaluation.integrate(block.integrate_values, block.integrate_gradients);
+    });
+  }
+
+  template <typename VectorType>
+  void
+  distribute_local_to_global(VectorType& vector)
+  {
+    static_for_each<n>([&](auto fe_number) {
+      constexpr unsigned int b = decltype(fe_number)::value;
+      auto& block = get_block<b>();
+      if (!(block.integrate_values || block.integrate_gradients))
+        return;
+      for (unsigned int side = 0; side < n_sides; ++side)
+      {
+        if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+            block.fe_evaluation[side]->distribute_local_to_global(vector.block(b));
+        else
+        {
+          static_assert(n == 1, "Multiple blocks need a block vector!");
+          block.fe_evaluation[side]->distribute_local_to_global(vector);
+        }
+      }
+    });
+  }
+
+  template <unsigned int fe_number>
+  auto&
+  get_fe_evaluation(const unsigned int side) const
+  {
+    AssertIndexRange(side, n_sides);
+    Assert(get_block<fe_number>().fe_evaluation[side] != nullptr, dealii::ExcInternalError());
+    return *get_block<fe_number>().fe_evaluation[side];
+  }
+
+  // Set all DoF values of the given block to zero on all sides.
+  template <unsigned int fe_number>
+  void
+  set_dof_values_to_zero()
+  {
+    const auto zero = typename FEFaceEvaluationType<fe_number>::value_type();
+    for (const auto& fe_evaluation : get_block<fe_number>().fe_evaluation)
+      if (fe_evaluation != nullptr)
+        for (unsigned int i = 0; i < fe_evaluation->dofs_per_component; ++i)
+          fe_evaluation->submit_dof_value(zero, i);
+  }
+
+  template <unsigned int fe_number>
+  auto
+  get_jump(unsigned int q) const
+  {
+    static_assert(domain == CFL::IntegrationDomain::face, "Jumps only exist on interior faces!");
+    return interior<fe_number>().get_value(q) - exterior<fe_number>().get_value(q);
+  }
+
+  template <unsigned int fe_number>
+  auto
+  get_average(unsigned int q) const
+  {
+    static_assert(domain == CFL::IntegrationDomain::face,
+                  "Averages only exist on interior faces!");
+    return (interior<fe_number>().get_value(q) + exterior<fe_number>().get_value(q)) * half();
+  }
+
+  // the average of the normal derivatives on interior faces, the interior one on the boundary
+  template <unsigned int fe_number>
+  auto
+  get_normal_derivative(unsigned int q) const
+  {
+    if constexpr(domain == CFL::IntegrationDomain::face)
+      return (interior<fe_number>().get_normal_derivative(q) +
+              exterior<fe_number>().get_normal_derivative(q)) *
+             half();
+    else
+      return interior<fe_number>().get_normal_derivative(q);
+  }
+
+  template <unsigned int fe_number>
+  auto
+  get_boundary_value(unsigned int q) const
+  {
+    static_assert(domain == CFL::IntegrationDomain::boundary,
+                  "Boundary values only exist on boundary faces!");
+    return interior<fe_number>().get_value(q);
+  }
+
+  template <unsigned int fe_number, typename ValueType>
+  void
+  submit_jump(const ValueType& value, unsigned int q)
+  {
+    static_assert(domain == CFL::IntegrationDomain::face, "Jumps only exist on interior faces!");
+    interior<fe_number>().submit_value(value, q);
+    exterior<fe_number>().submit_value(-value, q);
+  }
+
+  template <unsigned int fe_number, typename ValueType>
+  void
+  submit_average(const ValueType& value, unsigned int q)
+  {
+    static_assert(domain == CFL::IntegrationDomain::face,
+                  "Averages only exist on interior faces!");
+    const ValueType half_value = value * half();
+    interior<fe_number>().submit_value(half_value, q);
+    exterior<fe_number>().submit_value(half_value, q);
+  }
+
+  template <unsigned int fe_number, typename ValueType>
+  void
+  submit_normal_derivative(const ValueType& value, unsigned int q)
+  {
+    if constexpr(domain == CFL::IntegrationDomain::face)
+    {
+      const ValueType half_value = value * half();
+      interior<fe_number>().submit_normal_derivative(half_value, q);
+      exterior<fe_number>().submit_normal_derivative(half_value, q);
+    }
+    else
+      interior<fe_number>().submit_normal_derivative(value, q);
+  }
+
+  template <unsigned int fe_number, typename ValueType>
+  void
+  submit_boundary_value(const ValueType& value, unsigned int q)
+  {
+    static_assert(domain == CFL::IntegrationDomain::boundary,
+                  "Boundary values only exist on boundary faces!");
+    interior<fe_number>().submit_value(value, q);
+  }
+
+  /**
+   * The data submitted to the values or gradients of block @p fe_number in quadrature point
+   * @p q on all sides, see CFL::Form::submit_add(). Jumps and averages both submit values, so
+   * forms tested by them are added up through these.
+   */
+  template <unsigned int fe_number, bool gradient>
+  auto
+  get_submitted(unsigned int q) const
+  {
+    using Submitted = decltype(FEData<fe_number>::template get_submitted<gradient>(
+      std::declval<const FEFaceEvaluationType<fe_number>&>(), q));
+    std::array<Submitted, n_sides> submitted;
+    for (unsigned int side = 0; side < n_sides; ++side)
+      submitted[side] =
+        FEData<fe_number>::template get_submitted<gradient>(get_fe_evaluation<fe_number>(side), q);
+    return submitted;
+  }
+
+  template <unsigned int fe_number, bool gradient, typename SubmittedType>
+  void
+  add_submitted(const SubmittedType& submitted, unsigned int q)
+  {
+    for (unsigned int side = 0; side < n_sides; ++side)
+      FEData<fe_number>::template add_submitted<gradient>(
+        get_fe_evaluation<fe_number>(side), submitted[side], q);
+  }
+
+private:
+  template <unsigned int fe_number>
+  struct BlockData
+  {
+    std::array<std::shared_ptr<FEFaceEvaluationType<fe_number>>, n_sides> fe_evaluation;
+    bool evaluate_values = false;
+    bool evaluate_gradients = false;
+    bool integrate_values = false;
+    bool integrate_gradients = false;
+    const dealii::LinearAlgebra::distributed::Vector<NumberType>* bound_vector = nullptr;
+
+    bool
+    is_used() const
+    {
+      return evaluate_values || evaluate_gradients || integrate_values || integrate_gradients;
+    }
+  };
+
+  template <typename Sequence>
+  struct BlockTuple;
+
+  template <unsigned int... fe_numbers>
+  struct BlockTuple<std::integer_sequence<unsigned int, fe_numbers...>>
+  {
+    using type = std::tuple<BlockData<fe_numbers>...>;
+  };
+
+  typename BlockTuple<std::make_integer_sequence<unsigned int, n>>::type blocks;
+  unsigned int face_index = dealii::numbers::invalid_unsigned_int;
+  const dealii::VectorizedArray<NumberType>* cell_parameters = nullptr;
+  unsigned int n_cell_parameters = 0;
+
+  template <unsigned int fe_number>
+  BlockData<fe_number>&
+  get_block()
+  {
+    static_assert(fe_number < n, "Component not found!");
+    return std::get<fe_number>(blocks);
+  }
+
+  template <unsigned int fe_number>
+  const BlockData<fe_number>&
+  get_block() const
+  {
+    static_assert(fe_number < n, "Component not found!");
+    return std::get<fe_number>(blocks);
+  }
+
+  template <unsigned int fe_number>
+  auto&
+  interior() const
+  {
+    return *get_block<fe_number>().fe_evaluation[0];
+  }
+
+  template <unsigned int fe_number>
+  auto&
+  exterior() const
+  {
+    return *get_block<fe_number>().fe_evaluation[n_sides - 1];
+  }
+
+  static dealii::VectorizedArray<NumberType>
+  half()
+  {
+    dealii::VectorizedArray<NumberType> value;
+    value = NumberType(0.5);
+    return value;
+  }
+
+  // call fn(fe_evaluation, block) for all sides of all blocks used by the forms
+  template <typename Fn>
+  void
+  for_each_used_side(const Fn& fn)
+  {
+    static_for_each<n>([&](auto fe_number) {
+      auto& block = get_block<decltype(fe_number)::value>();
+      if (block.is_used())
+        for (auto& fe_evaluation : block.fe_evaluation)
+          fn(*fe_evaluation, block);
+    });
+  }
+};
+
+#endif // FE_FACE_DATA_H
@@ -1,12 +1,48 @@
 #ifndef MATRIX_FREE_INTEGRATOR_H
 #define MATRIX_FREE_INTEGRATOR_H
 
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/matrix_free/operators.h>
 
 #include <cfl/dealii_matrixfree.h> //for BlockVectors
 #include <cfl/static_for.h>
 #include <cfl/traits.h>
+#include <deal.II/lac/block_sparse_matrix.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <dealii/fe_face_data.h>
+#include <dealii/phase_counters.h>
+#include <dealii/tensor_product_kernels.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+/**
+ * A shared_ptr to @p data that does not own it. Operators initialized with it share @p data
+ * instead of holding a copy of all its mapping and DoF index data, so @p data has to outlive
+ * them. To let the operators own the MatrixFree object jointly, create it with
+ * std::make_shared and pass the same shared_ptr to all of them instead.
+ */
+template <int dim, typename Number>
+std::shared_ptr<const dealii::MatrixFree<dim, Number>>
+make_matrix_free_handle(const dealii::MatrixFree<dim, Number>& data)
+{
+  return std::shared_ptr<const dealii::MatrixFree<dim, Number>>(
+    &data, [](const dealii::MatrixFree<dim, Number>* /*unused*/) {});
+}
 
 template <int dim, typename VectorType, class Enable = void>
 class MatrixFreeIntegratorBaseBase;
@@ -29,12 +65,26 @@ public:
   using Base = dealii::MatrixFreeOperators::Base<dim, VectorType>;
 };
 
+/**
+ * How MatrixFreeIntegrator applies the cell terms of its form: by sum factorization in every
+ * vmult, by multiplying with element matrices computed once from the form, or by the faster
+ * of the two as measured when the element matrices are set up.
+ */
+enum class ExecutionMode
+{
+  matrix_free,
+  element_matrices,
+  automatic
+};
+
 template <int dim, typename VectorType, class FORM, class FEDatas>
 class MatrixFreeIntegratorBase : public MatrixFreeIntegratorBaseBase<dim, VectorType>
 {
 public:
   using Number = typename VectorType::value_type;
   using Base = MatrixFreeIntegratorBaseBase<dim, VectorType>;
+  using VectorizedArrayType = dealii::VectorizedArray<Number>;
+  using BlockType = dealii::LinearAlgebra::distributed::Vector<Number>;
 
   void
   initialize(const std::shared_ptr<const dealii::MatrixFree<dim, Number>>& data_,
@@ -47,16 +97,449 @@ public:
   void
   initialize(const dealii::MatrixFree<dim, Number>& data_, const FORM& form_, FEDatas fe_datas_)
   {
-    Base::Base::initialize(std::make_shared<const dealii::MatrixFree<dim, Number>>(data_));
+    Base::Base::initialize(make_matrix_free_handle(data_));
     initialize(form_, fe_datas_);
   }
 
+  /**
+   * Compute the diagonal blocks of all cell matrices, i.e. the coupling of each block tested
+   * by the form with itself, and store them per cell batch. Like the diagonal, they are
+   * computed from the quadrature point operator by sum factorization. Only the cell terms of
+   * the form are included.
+   */
+  void
+  compute_cell_block_diagonal()
+  {
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    update_bound_ghost_values();
+    cell_block_diagonal.resize(FEDatas::n);
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      const auto integration_flags = fe_datas->template get_integration_flags<b>();
+      const unsigned int n_dofs =
+        (integration_flags[0] || integration_flags[1]) ? n_block_dofs<b>() : 0;
+      cell_block_diagonal[b].resize_fast(this->data->n_macro_cells() * n_dofs * n_dofs);
+    });
+    unsigned int dummy = 0;
+    this->data->cell_loop(
+      &MatrixFreeIntegratorBase::local_cell_block_diagonal, this, dummy, dummy);
+  }
+
+  /**
+   * The cell matrix of block @p block on the cell batch @p cell, stored row-wise with the
+   * lexicographic DoF numbering of FEEvaluation. Returns nullptr if @p block is not tested by
+   * the form.
+   */
+  const VectorizedArrayType*
+  get_cell_block_diagonal(const unsigned int block, const unsigned int cell) const
+  {
+    AssertIndexRange(block, cell_block_diagonal.size());
+    if (cell_block_diagonal[block].size() == 0)
+      return nullptr;
+    const unsigned int size = cell_block_diagonal[block].size() / this->data->n_macro_cells();
+    return cell_block_diagonal[block].begin() + cell * size;
+  }
+
+  /**
+   * Choose how the cell terms of the form are applied, see ExecutionMode, and set up the
+   * element matrices if needed. Element matrices trade the sum factorization kernels for a
+   * dense matrix-vector product per cell batch, which is faster for low polynomial degrees.
+   * Face and boundary terms are always applied matrix-free. With ExecutionMode::automatic,
+   * both variants are timed for a few applications of the operator and the faster one is kept.
+   */
+  void
+  set_execution_mode(const ExecutionMode mode)
+  {
+    execution_mode = mode;
+    update_element_matrices();
+  }
+
+  // true if vmult uses element matrices for the cell terms
+  bool
+  uses_element_matrices() const
+  {
+    return element_matrices.size() > 0;
+  }
+
+  /**
+   * Compute the element matrices of all cell batches unless the execution mode is
+   * ExecutionMode::matrix_free. They are the derivatives of the cell terms with respect to the
+   * blocks not bound to a vector, at the linearization point given by the bound vectors, so the
+   * operator has to be linear in these blocks. Has to be called again after changing the bound
+   * vectors, Coefficient or CellParameter values, or reinitializing the MatrixFree object.
+   */
+  void
+  update_element_matrices()
+  {
+    element_matrices.clear();
+    if (execution_mode == ExecutionMode::matrix_free || !use_cell)
+      return;
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    update_bound_ghost_values();
+    setup_element_matrix_layout();
+    element_matrices.resize_fast(this->data->n_macro_cells() * element_matrix_size *
+                                 element_matrix_size);
+    unsigned int dummy = 0;
+    this->data->cell_loop(
+      &MatrixFreeIntegratorBase::local_element_matrices, this, dummy, dummy);
+    if (execution_mode == ExecutionMode::automatic &&
+        time_cell_loop(true) >= time_cell_loop(false))
+      element_matrices.clear();
+  }
+
+  /**
+   * Add the cell terms of the form to @p matrix, eliminating the constrained DoFs by
+   * ConstraintMatrix::distribute_local_to_global() with @p constraints. The cell matrices are
+   * computed like the element matrices, see update_element_matrices(), by the vectorized
+   * evaluate and integrate kernels of all lanes of a cell batch at once. The form may test and
+   * evaluate only one block (apart from blocks bound to a vector), use the BlockSparseMatrix
+   * variant otherwise. On a multigrid level, the level DoF indices are used.
+   */
+  template <typename OtherNumber>
+  void
+  assemble_matrix(dealii::SparseMatrix<OtherNumber>& matrix,
+                  const dealii::ConstraintMatrix& constraints)
+  {
+    setup_element_matrix_layout();
+    AssertThrow(std::count(element_matrix_rows.begin(), element_matrix_rows.end(), true) <= 1 &&
+                  std::count(element_matrix_columns.begin(), element_matrix_columns.end(), true) <=
+                    1,
+                dealii::ExcMessage("The form couples several blocks, use a BlockSparseMatrix."));
+    assemble_matrix(
+      [&](const unsigned int, const unsigned int) -> dealii::SparseMatrix<OtherNumber>& {
+        return matrix;
+      },
+      [&](const unsigned int) -> const dealii::ConstraintMatrix& { return constraints; });
+  }
+
+  /**
+   * Add the cell terms of the form to @p matrix, with the coupling of block i to block j in
+   * matrix.block(i, j). The constraints of block i are given by @p constraints[i].
+   */
+  template <typename OtherNumber>
+  void
+  assemble_matrix(dealii::BlockSparseMatrix<OtherNumber>& matrix,
+                  const std::vector<const dealii::ConstraintMatrix*>& constraints)
+  {
+    AssertDimension(constraints.size(), FEDatas::n);
+    assemble_matrix(
+      [&](const unsigned int row, const unsigned int column) -> dealii::SparseMatrix<OtherNumber>& {
+        return matrix.block(row, column);
+      },
+      [&](const unsigned int block) -> const dealii::ConstraintMatrix& {
+        return *constraints[block];
+      });
+  }
+
+  /**
+   * Let all FEFunction objects with index @p fe_number read their DoF values from @p vector
+   * instead of the corresponding block of the source vector, e.g. to provide the
+   * linearization point of a Jacobian. The vector is not copied, so it has to stay alive and
+   * unchanged while bound. Bind it again after changing it. Binding drops the linearization
+   * cache, so the bound vectors are evaluated in every application of the operator until
+   * update_linearization_cache() is called once all vectors are bound.
+   */
+  void
+  bind_fe_function(const unsigned int fe_number, const BlockType& vector)
+  {
+    AssertIndexRange(fe_number, FEDatas::n);
+    vector.update_ghost_values();
+    bound_vectors[fe_number] = &vector;
+    linearization_cache.clear();
+    // the bound blocks are not exchanged by overlapping_cell_loop()
+    cell_batches_sorted = false;
+  }
+
+  void
+  unbind_fe_functions()
+  {
+    bound_vectors.fill(nullptr);
+    linearization_cache.clear();
+    cell_batches_sorted = false;
+  }
+
+  bool
+  is_bound(const unsigned int fe_number) const
+  {
+    AssertIndexRange(fe_number, FEDatas::n);
+    return bound_vectors[fe_number] != nullptr;
+  }
+
+  /**
+   * Keep the values and gradients of the bound blocks (see bind_fe_function()) in all
+   * quadrature points of all cell batches, instead of evaluating them in every application of
+   * the operator. This trades the evaluation for reading the stored data, which pays off in
+   * Krylov solvers applying the operator many times for the same linearization point. The
+   * stored data is updated by update_linearization_cache(). Face terms always evaluate the
+   * bound vectors.
+   */
+  void
+  enable_linearization_cache(const bool enable = true)
+  {
+    use_linearization_cache = enable;
+    update_linearization_cache();
+  }
+
+  /**
+   * Evaluate the bound vectors in the quadrature points of all cell batches and store the
+   * result. Has to be called whenever a bound vector changes while the cache is enabled.
+   * Blocks evaluating hessians are not cached.
+   */
+  void
+  update_linearization_cache()
+  {
+    linearization_cache.clear();
+    const bool any_bound = std::any_of(
+      bound_vectors.begin(), bound_vectors.end(), [](const auto* v) { return v != nullptr; });
+    if (!use_linearization_cache || !any_bound || !use_cell)
+      return;
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    update_bound_ghost_values();
+    linearization_cache.resize(FEDatas::n);
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      if (bound_vectors[b] != nullptr)
+        linearization_cache[b].resize_fast(this->data->n_macro_cells() *
+                                           fe_datas->template n_quadrature_data<b>());
+    });
+    unsigned int dummy = 0;
+    this->data->cell_loop(
+      &MatrixFreeIntegratorBase::local_linearization_cache, this, dummy, dummy);
+  }
+
+  /**
+   * Set the values of the CellParameter objects with index @p index from @p values, given per
+   * active cell, i.e. indexed by active_cell_index(), or per cell of the level for operators
+   * on a multigrid level. The values are gathered into the order of the cell batches once here,
+   * such that the cell loop reads a single VectorizedArray per cell batch. Unused lanes repeat
+   * the first one. Interior faces get the larger value of the two adjacent cells, e.g. for
+   * penalty factors, and boundary faces the one of the interior cell. Has to be called again
+   * if the MatrixFree object is reinitialized.
+   */
+  template <typename OtherNumber>
+  void
+  set_cell_parameter(const unsigned int index, const dealii::Vector<OtherNumber>& values)
+  {
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    constexpr unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+    const unsigned int n_cell_batches = this->data->n_macro_cells();
+    const unsigned int n_inner_face_batches = this->data->n_inner_face_batches();
+    const unsigned int n_face_batches =
+      n_inner_face_batches + this->data->n_boundary_face_batches();
+    if (index >= n_cell_parameters)
+    {
+      add_parameter_slots(cell_parameters, n_cell_batches, index + 1);
+      add_parameter_slots(face_parameters, n_face_batches, index + 1);
+      n_cell_parameters = index + 1;
+    }
+
+    const bool is_level =
+      this->data->get_level_mg_handler() != dealii::numbers::invalid_unsigned_int;
+    for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+    {
+      VectorizedArrayType& value = cell_parameters[cell * n_cell_parameters + index];
+      const unsigned int n_filled = this->data->n_components_filled(cell);
+      for (unsigned int lane = 0; lane < n_lanes; ++lane)
+      {
+        const auto cell_iterator =
+          this->data->get_cell_iterator(cell, std::min(lane, n_filled - 1));
+        const unsigned int i =
+          is_level ? cell_iterator->index() : cell_iterator->active_cell_index();
+        AssertIndexRange(i, values.size());
+        value[lane] = values(i);
+      }
+    }
+
+    // the faces store the cells adjacent to each lane as cell batch * n_lanes + lane
+    const auto cell_value = [&](const unsigned int cell_and_lane) {
+      return cell_parameters[(cell_and_lane / n_lanes) * n_cell_parameters +
+                             index][cell_and_lane % n_lanes];
+    };
+    for (unsigned int face = 0; face < n_face_batches; ++face)
+    {
+      const auto& face_info = this->data->get_face_info(face);
+      VectorizedArrayType& value = face_parameters[face * n_cell_parameters + index];
+      for (unsigned int lane = 0; lane < n_lanes; ++lane)
+      {
+        if (face_info.cells_interior[lane] == dealii::numbers::invalid_unsigned_int)
+        {
+          value[lane] = value[0];
+          continue;
+        }
+        value[lane] = cell_value(face_info.cells_interior[lane]);
+        if (face < n_inner_face_batches)
+          value[lane] = std::max(value[lane], cell_value(face_info.cells_exterior[lane]));
+      }
+    }
+  }
+
+  /**
+   * Evaluate the Coefficient @p coefficient in the quadrature points of all cell batches of
+   * this operator and store the values here. The forms of this operator holding copies of
+   * @p coefficient then read the stored values instead of calling its function, like the
+   * values given by set_cell_parameter(). Other operators, e.g. on other multigrid levels, are
+   * not affected. Has to be called again after initialize().
+   */
+  template <class CoefficientType>
+  void
+  cache_coefficient(const CoefficientType& coefficient)
+  {
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    clear_coefficient(coefficient);
+    const unsigned int n_cell_batches = this->data->n_macro_cells();
+    const unsigned int n_q_points = FEDatas::get_n_q_points();
+    constexpr unsigned int n_components = CoefficientType::n_components;
+    CoefficientValues<Number> cached;
+    cached.id = coefficient.get_id();
+    cached.n_values_per_cell = n_q_points * n_components;
+    cached.values.resize_fast(n_cell_batches * cached.n_values_per_cell);
+    FEDatas& phi = get_fe_datas();
+    for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+    {
+      phi.reinit(cell);
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        coefficient.evaluate_components(
+          phi, q, cached.values.begin() + cell * cached.n_values_per_cell + q * n_components);
+    }
+    coefficient_values.push_back(std::move(cached));
+  }
+
+  // Go back to calling the function of @p coefficient in every quadrature point.
+  template <class CoefficientType>
+  void
+  clear_coefficient(const CoefficientType& coefficient)
+  {
+    coefficient_values.erase(std::remove_if(coefficient_values.begin(),
+                                            coefficient_values.end(),
+                                            [&](const CoefficientValues<Number>& values) {
+                                              return values.id == coefficient.get_id();
+                                            }),
+                             coefficient_values.end());
+  }
+
+  /**
+   * The memory used by this operator, i.e. the inverse diagonal, the cell block diagonals, the
+   * element matrices and the linearization cache. The MatrixFree object is not included since
+   * it is usually shared with other operators, see make_matrix_free_handle().
+   */
+  std::size_t
+  memory_consumption() const override
+  {
+    std::size_t memory = Base::Base::memory_consumption();
+    for (const auto& block : cell_block_diagonal)
+      memory += block.memory_consumption();
+    memory += element_matrices.memory_consumption();
+    memory += cell_parameters.memory_consumption() + face_parameters.memory_consumption();
+    for (const auto& coefficient : coefficient_values)
+      memory += coefficient.values.memory_consumption();
+    for (const auto& block : linearization_cache)
+      memory += block.memory_consumption();
+    return memory;
+  }
+
+  /**
+   * The cycles spent in the phases of the cell loop of all vmults since the last call of
+   * initialize() or reset_phase_counters(), summed over all threads. The counters are only
+   * updated if PHASE_COUNTERS is defined, e.g. by configuring with -DPHASE-COUNTERS=ON.
+   * Otherwise they stay zero and the cell loop is not instrumented at all.
+   */
+  PhaseCounters
+  get_phase_counters() const
+  {
+    std::lock_guard<std::mutex> lock(phase_counters_mutex);
+    PhaseCounters sum(FEDatas::n);
+    for (const auto& counters : thread_phase_counters)
+      sum += counters;
+    return sum;
+  }
+
+  void
+  reset_phase_counters()
+  {
+    std::lock_guard<std::mutex> lock(phase_counters_mutex);
+    for (auto& counters : thread_phase_counters)
+      counters.reset();
+  }
+
+  void
+  print_phase_counters(std::ostream& out) const
+  {
+    get_phase_counters().print(out);
+  }
+
 protected:
+  using FaceDatas = FEFaceDatas<FEDatas, CFL::IntegrationDomain::face>;
+  using BoundaryDatas = FEFaceDatas<FEDatas, CFL::IntegrationDomain::boundary>;
+
+  // The loops to run follow from the test functions used in the form, such that operators
+  // without face terms never touch faces.
+  static constexpr bool use_cell = FORM::has_cell_forms;
+  static constexpr bool use_face = FORM::has_face_forms;
+  static constexpr bool use_boundary = FORM::has_boundary_forms;
+
   std::shared_ptr<const FORM> form = nullptr;
   std::shared_ptr<FEDatas> fe_datas = nullptr;
-  bool use_cell = false;
-  bool use_face = false;
-  bool use_boundary = false;
+  std::shared_ptr<FaceDatas> face_datas = nullptr;
+  std::shared_ptr<BoundaryDatas> boundary_datas = nullptr;
+  // the vectors bound to the FEFunction objects of each block, nullptr if not bound
+  std::array<const BlockType*, FEDatas::n> bound_vectors{};
+  // Every worker thread of the loops gets its own copies of fe_datas, face_datas and
+  // boundary_datas with separate FEEvaluation objects. The members above only serve as
+  // prototypes holding the flags.
+  mutable dealii::Threads::ThreadLocalStorage<std::shared_ptr<FEDatas>> fe_datas_pool;
+  // one more copy of fe_datas per thread and vector of vmult_multiple(), see get_fe_datas()
+  mutable dealii::Threads::ThreadLocalStorage<std::vector<std::shared_ptr<FEDatas>>>
+    fe_datas_multiple_pool;
+  mutable dealii::Threads::ThreadLocalStorage<std::shared_ptr<FaceDatas>> face_datas_pool;
+  mutable dealii::Threads::ThreadLocalStorage<std::shared_ptr<BoundaryDatas>>
+    boundary_datas_pool;
+  // per thread scratch memory for the diagonal computation, only grows
+  mutable dealii::Threads::ThreadLocalStorage<dealii::AlignedVector<VectorizedArrayType>>
+    scratch_pool;
+  // filled inside the (const) cell loop of compute_cell_block_diagonal
+  mutable std::vector<dealii::AlignedVector<VectorizedArrayType>> cell_block_diagonal;
+  // the quadrature point data of the nonlinear blocks per cell batch, empty if not cached
+  bool use_linearization_cache = false;
+  mutable std::vector<dealii::AlignedVector<VectorizedArrayType>> linearization_cache;
+  // the blocks and ranges of cell batches of overlapping_cell_loop(), set up on first use
+  mutable bool cell_batches_sorted = false;
+  mutable std::vector<unsigned int> exchanged_src_blocks;
+  mutable std::vector<unsigned int> exchanged_dst_blocks;
+  mutable std::array<std::vector<std::pair<unsigned int, unsigned int>>, 3> overlap_cell_ranges;
+  // the ranges of locally owned DoFs first read and last written per cell batch, vmult_fused()
+  mutable std::vector<std::vector<std::pair<unsigned int, unsigned int>>> dof_ranges_before;
+  mutable std::vector<std::vector<std::pair<unsigned int, unsigned int>>> dof_ranges_after;
+  // the refinement edge DoFs of each block on a multigrid level, see vmult_multiple()
+  std::vector<std::vector<unsigned int>> edge_constrained_dofs;
+  // n_cell_parameters values of the CellParameter objects per cell and face batch
+  unsigned int n_cell_parameters = 0;
+  dealii::AlignedVector<VectorizedArrayType> cell_parameters;
+  dealii::AlignedVector<VectorizedArrayType> face_parameters;
+  // the values of the Coefficient objects given to cache_coefficient()
+  std::vector<CoefficientValues<Number>> coefficient_values;
+  // the element matrices of all cell batches, empty if the cell terms are applied matrix-free
+  ExecutionMode execution_mode = ExecutionMode::matrix_free;
+  mutable dealii::AlignedVector<VectorizedArrayType> element_matrices;
+  unsigned int element_matrix_size = 0;
+  std::array<unsigned int, FEDatas::n> element_matrix_offsets{};
+  std::array<bool, FEDatas::n> element_matrix_rows{};
+  std::array<bool, FEDatas::n> element_matrix_columns{};
+  // the PhaseCounters of each thread running the cell loop, see get_phase_counters()
+  mutable std::mutex phase_counters_mutex;
+  mutable std::deque<PhaseCounters> thread_phase_counters;
+  mutable dealii::Threads::ThreadLocalStorage<PhaseCounters*> phase_counters_pool;
+
+  // append zero parameters to each of the @p n_batches batches of @p parameters
+  void
+  add_parameter_slots(dealii::AlignedVector<VectorizedArrayType>& parameters,
+                      const unsigned int n_batches, const unsigned int new_n_parameters) const
+  {
+    dealii::AlignedVector<VectorizedArrayType> new_parameters(n_batches * new_n_parameters);
+    for (unsigned int batch = 0; batch < n_batches; ++batch)
+      for (unsigned int i = 0; i < n_cell_parameters; ++i)
+        new_parameters[batch * new_n_parameters + i] = parameters[batch * n_cell_parameters + i];
+    parameters.swap(new_parameters);
+  }
 
   // convenience function to avoid shared_ptr
   void
@@ -66,34 +549,843 @@ protected:
   }
 
   void
-  initialize(const std::shared_ptr<FORM>& form_, std::shared_ptr<FEDatas>& fe_datas_)
+  initialize(const std::shared_ptr<FORM>& form_, const std::shared_ptr<FEDatas>& fe_datas_)
   {
     form = form_;
     fe_datas = fe_datas_;
-    // TODO(darndt): Determine from form.
-    use_cell = true;
-    use_face = false;
-    use_boundary = false;
     form->set_evaluation_flags(*fe_datas);
     form->set_integration_flags(*fe_datas);
     Assert(this->data != nullptr, dealii::ExcNotInitialized());
     fe_datas->initialize(*(this->data));
+    if constexpr(use_face)
+    {
+      face_datas = std::make_shared<FaceDatas>();
+      form->set_evaluation_flags(*face_datas);
+      form->set_integration_flags(*face_datas);
+    }
+    if constexpr(use_boundary)
+    {
+      boundary_datas = std::make_shared<BoundaryDatas>();
+      form->set_evaluation_flags(*boundary_datas);
+      form->set_integration_flags(*boundary_datas);
+    }
+    fe_datas_pool.clear();
+    fe_datas_multiple_pool.clear();
+    face_datas_pool.clear();
+    boundary_datas_pool.clear();
+    scratch_pool.clear();
+    cell_block_diagonal.clear();
+    linearization_cache.clear();
+    element_matrices.clear();
+    edge_constrained_dofs.clear();
+    dof_ranges_before.clear();
+    dof_ranges_after.clear();
+    cell_batches_sorted = false;
+    n_cell_parameters = 0;
+    cell_parameters.clear();
+    face_parameters.clear();
+    coefficient_values.clear();
+    phase_counters_pool.clear();
+    thread_phase_counters.clear();
+  }
+
+  /**
+   * Return the copy of @p prototype owned by the calling thread. It is created on first use
+   * and initialized with new FEEvaluation objects, such that concurrent cell or face batches
+   * never share quadrature or DoF buffers. The bound vectors and the cell parameters
+   * @p parameters are passed on to it.
+   */
+  template <class Datas>
+  Datas&
+  get_thread_local_copy(dealii::Threads::ThreadLocalStorage<std::shared_ptr<Datas>>& pool,
+                        const std::shared_ptr<Datas>& prototype,
+                        const dealii::AlignedVector<VectorizedArrayType>& parameters) const
+  {
+    return get_local_copy(pool.get(), prototype, parameters);
+  }
+
+  // create @p local_datas from @p prototype if needed and pass on the bound vectors
+  template <class Datas>
+  Datas&
+  get_local_copy(std::shared_ptr<Datas>& local_datas, const std::shared_ptr<Datas>& prototype,
+                 const dealii::AlignedVector<VectorizedArrayType>& parameters) const
+  {
+    if (local_datas == nullptr)
+    {
+      Assert(prototype != nullptr, dealii::ExcNotInitialized());
+      local_datas = std::make_shared<Datas>(*prototype);
+      local_datas->initialize(*(this->data));
+    }
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      local_datas->template bind_dof_values<b>(bound_vectors[b]);
+    });
+    local_datas->set_cell_parameters(parameters.begin(), n_cell_parameters);
+    return *local_datas;
+  }
+
+  FEDatas&
+  get_fe_datas() const
+  {
+    FEDatas& phi = get_thread_local_copy(fe_datas_pool, fe_datas, cell_parameters);
+    phi.set_coefficient_values(&coefficient_values);
+    return phi;
+  }
+
+  /**
+   * Like get_fe_datas(), but @p n_vectors separate copies of the calling thread, one per
+   * vector of vmult_multiple(), so that all vectors of a cell batch can be in the quadrature
+   * points at the same time.
+   */
+  std::vector<std::shared_ptr<FEDatas>>&
+  get_fe_datas(const unsigned int n_vectors) const
+  {
+    std::vector<std::shared_ptr<FEDatas>>& local_datas = fe_datas_multiple_pool.get();
+    if (local_datas.size() < n_vectors)
+      local_datas.resize(n_vectors);
+    for (unsigned int v = 0; v < n_vectors; ++v)
+      get_local_copy(local_datas[v], fe_datas, cell_parameters)
+        .set_coefficient_values(&coefficient_values);
+    return local_datas;
+  }
+
+  FaceDatas&
+  get_face_datas() const
+  {
+    return get_thread_local_copy(face_datas_pool, face_datas, face_parameters);
+  }
+
+  BoundaryDatas&
+  get_boundary_datas() const
+  {
+    return get_thread_local_copy(boundary_datas_pool, boundary_datas, face_parameters);
+  }
+
+  // the PhaseCounters of the calling thread, created on first use
+  PhaseCounters*
+  get_phase_counters_of_thread() const
+  {
+    PhaseCounters*& counters = phase_counters_pool.get();
+    if (counters == nullptr)
+    {
+      std::lock_guard<std::mutex> lock(phase_counters_mutex);
+      thread_phase_counters.emplace_back(FEDatas::n);
+      counters = &thread_phase_counters.back();
+    }
+    return counters;
   }
 
   void
   apply_add(VectorType& dst, const VectorType& src) const override
   {
-    if (use_cell)
-      Base::data->cell_loop(&MatrixFreeIntegratorBase::local_apply_cell, this, dst, src);
-    if (use_face)
+    const auto cell_operation = element_matrices.size() == 0
+                                  ? &MatrixFreeIntegratorBase::local_apply_cell
+                                  : &MatrixFreeIntegratorBase::local_apply_element_matrices;
+    if constexpr(CFL::Traits::is_block_vector<VectorType>::value && !use_face && !use_boundary)
+    {
+      if (dealii::MultithreadInfo::n_threads() == 1 &&
+          dealii::Utilities::MPI::n_mpi_processes(src.block(0).get_mpi_communicator()) > 1)
+      {
+        overlapping_cell_loop(cell_operation, dst, src);
+        return;
+      }
+    }
+    // MatrixFree needs to be set up with the face update flags for face or boundary terms
+    if constexpr(use_face || use_boundary)
+      Base::data->loop(cell_operation,
+                       &MatrixFreeIntegratorBase::local_apply_face,
+                       &MatrixFreeIntegratorBase::local_apply_boundary,
+                       this,
+                       dst,
+                       src);
+    else
+      Base::data->cell_loop(cell_operation, this, dst, src);
+  }
+
+  /**
+   * The cell loop of apply_add() for block vectors with one thread per process. Unlike the
+   * loops of MatrixFree, which exchange all blocks of both vectors, only the blocks of @p src
+   * read by the form and the blocks of @p dst tested by it are exchanged. The ghost exchange of
+   * all these blocks is started at once, and half of the cell batches not touching any ghost
+   * DoF are processed while it is in flight. Then the cell batches touching ghost DoFs follow,
+   * and the other half of the interior batches overlaps with the compress of all blocks.
+   */
+  template <typename CellOperation>
+  void
+  overlapping_cell_loop(const CellOperation& cell_operation, VectorType& dst,
+                        const VectorType& src) const
+  {
+    if (!cell_batches_sorted)
+      sort_cell_batches();
+    const auto run = [&](const std::vector<std::pair<unsigned int, unsigned int>>& ranges) {
+      for (const auto& range : ranges)
+        (this->*cell_operation)(*this->data, dst, src, range);
+    };
+
+    // each block communicates on its own channel, such that the messages do not mix
+    std::vector<unsigned int> updated_blocks;
+    for (const unsigned int b : exchanged_src_blocks)
+      if (!src.block(b).has_ghost_elements())
+      {
+        src.block(b).update_ghost_values_start(b);
+        updated_blocks.push_back(b);
+      }
+    for (const unsigned int b : exchanged_dst_blocks)
+      dst.block(b).zero_out_ghosts();
+    run(overlap_cell_ranges[0]);
+    for (const unsigned int b : updated_blocks)
+      src.block(b).update_ghost_values_finish();
+    run(overlap_cell_ranges[1]);
+    for (const unsigned int b : exchanged_dst_blocks)
+      dst.block(b).compress_start(src.n_blocks() + b, dealii::VectorOperation::add);
+    run(overlap_cell_ranges[2]);
+    for (const unsigned int b : exchanged_dst_blocks)
+      dst.block(b).compress_finish(dealii::VectorOperation::add);
+    for (const unsigned int b : updated_blocks)
+      src.block(b).zero_out_ghosts();
+  }
+
+  /**
+   * Find the blocks exchanged by overlapping_cell_loop() and sort the cell batches into ranges
+   * of consecutive batches: the first and the second half of the batches not touching ghost
+   * DoFs of these blocks, and the batches touching them, with the DoFs of the batches from
+   * get_resolved_dof_indices().
+   */
+  void
+  sort_cell_batches() const
+  {
+    exchanged_src_blocks.clear();
+    exchanged_dst_blocks.clear();
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      const auto evaluation_flags = fe_datas->template get_evaluation_flags<b>();
+      const auto integration_flags = fe_datas->template get_integration_flags<b>();
+      const bool is_read =
+        (evaluation_flags[0] || evaluation_flags[1] || evaluation_flags[2]) && !is_bound(b);
+      const bool is_written = integration_flags[0] || integration_flags[1];
+      if (is_read)
+        exchanged_src_blocks.push_back(b);
+      if (is_written)
+        exchanged_dst_blocks.push_back(b);
+    });
+
+    // a batch touches ghosts if it reads or writes them through hanging node constraints, too
+    const unsigned int n_cell_batches = this->data->n_macro_cells();
+    std::vector<bool> touches_ghosts(n_cell_batches, false);
+    std::vector<unsigned int> indices;
+    for (unsigned int b = 0; b < FEDatas::n; ++b)
+    {
+      if (std::find(exchanged_src_blocks.begin(), exchanged_src_blocks.end(), b) ==
+            exchanged_src_blocks.end() &&
+          std::find(exchanged_dst_blocks.begin(), exchanged_dst_blocks.end(), b) ==
+            exchanged_dst_blocks.end())
+        continue;
+      const unsigned int local_size = this->data->get_vector_partitioner(b)->local_size();
+      for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+        for (unsigned int lane = 0; lane < this->data->n_components_filled(cell); ++lane)
+        {
+          get_resolved_dof_indices(cell, lane, b, indices);
+          for (const unsigned int i : indices)
+            if (i >= local_size)
+              touches_ghosts[cell] = true;
+        }
+    }
+
+    const unsigned int n_interior =
+      std::count(touches_ghosts.begin(), touches_ghosts.end(), false);
+    for (auto& ranges : overlap_cell_ranges)
+      ranges.clear();
+    unsigned int n_visited_interior = 0;
+    for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+    {
+      unsigned int part = 1;
+      if (!touches_ghosts[cell])
+        part = (2 * n_visited_interior++ < n_interior) ? 0 : 2;
+      auto& ranges = overlap_cell_ranges[part];
+      if (!ranges.empty() && ranges.back().second == cell)
+        ++ranges.back().second;
+      else
+        ranges.emplace_back(cell, cell + 1);
+    }
+    cell_batches_sorted = true;
+  }
+
+  // apply_add() for several vectors in one loop over the cell and face batches
+  void
+  apply_add_multiple(std::vector<VectorType>& dst, const std::vector<VectorType>& src) const
+  {
+    const auto cell_operation =
+      element_matrices.size() == 0
+        ? &MatrixFreeIntegratorBase::local_apply_cell_multiple
+        : &MatrixFreeIntegratorBase::local_apply_element_matrices_multiple;
+    if constexpr(use_face || use_boundary)
+      Base::data->loop(cell_operation,
+                       &MatrixFreeIntegratorBase::local_apply_face_multiple,
+                       &MatrixFreeIntegratorBase::local_apply_boundary_multiple,
+                       this,
+                       dst,
+                       src);
+    else
+      Base::data->cell_loop(cell_operation, this, dst, src);
+  }
+
+  /**
+   * Set dst[v] to the operator applied to src[v] for all v, treating constrained DoFs like
+   * vmult() does. The vectors are processed in a single loop over the cell and face batches:
+   * on cells, the quadrature point loop runs once for all vectors, see
+   * local_apply_cell_multiple(); faces are reinitialized once and then applied to each vector
+   * in turn. The refinement edge indices on multigrid levels are kept in this class, since the
+   * storage of MatrixFreeOperators::Base only holds the values of one vector.
+   */
+  void
+  vmult_multiple(std::vector<VectorType>& dst, const std::vector<VectorType>& src) const
+  {
+    AssertDimension(dst.size(), src.size());
+    for (VectorType& vector : dst)
+      vector = Number(0.);
+    // like MatrixFreeOperators::Base, zero the edge entries of src during the loop
+    std::vector<Number> edge_values;
+    for (unsigned int v = 0; v < src.size(); ++v)
+      for (unsigned int b = 0; b < edge_constrained_dofs.size(); ++b)
+        for (const unsigned int i : edge_constrained_dofs[b])
+        {
+          Number& value = const_cast<BlockType&>(get_block(src[v], b)).local_element(i);
+          edge_values.push_back(value);
+          value = Number(0.);
+        }
+
+    apply_add_multiple(dst, src);
+
+    // constrained and edge entries are passed through from src as in vmult()
+    auto edge_value = edge_values.begin();
+    for (unsigned int v = 0; v < src.size(); ++v)
+    {
+      for (unsigned int b = 0; b < edge_constrained_dofs.size(); ++b)
+        for (const unsigned int i : edge_constrained_dofs[b])
+        {
+          const_cast<BlockType&>(get_block(src[v], b)).local_element(i) = *edge_value;
+          get_block(dst[v], b).local_element(i) = *edge_value++;
+        }
+      for (unsigned int b = 0; b < n_blocks(src[v]); ++b)
+        for (const unsigned int i : this->data->get_constrained_dofs(b))
+          get_block(dst[v], b).local_element(i) = get_block(src[v], b).local_element(i);
+    }
+  }
+
+  // the locally owned refinement edge indices of @p mg_constrained_dofs for block @p block
+  void
+  add_edge_constrained_dofs(const dealii::MGConstrainedDoFs& mg_constrained_dofs,
+                            const unsigned int level, const unsigned int block)
+  {
+    if (edge_constrained_dofs.size() <= block)
+      edge_constrained_dofs.resize(block + 1);
+    const auto& partitioner = this->data->get_vector_partitioner(block);
+    const auto& edge_indices = mg_constrained_dofs.get_refinement_edge_indices(level);
+    for (const auto index : edge_indices.get_index_vector())
+      if (partitioner->in_local_range(index))
+        edge_constrained_dofs[block].push_back(partitioner->global_to_local(index));
+  }
+
+  template <typename Vector>
+  static auto&
+  get_block(Vector& vector, const unsigned int block)
+  {
+    if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+      return vector.block(block);
+    else
+    {
+      AssertIndexRange(block, 1);
+      return vector;
+    }
+  }
+
+  static unsigned int
+  n_blocks(const VectorType& vector)
+  {
+    if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+      return vector.n_blocks();
+    else
+      return 1;
+  }
+
+  /**
+   * vmult() for non-block vectors, calling @p operation_before(begin, end) on ranges of locally
+   * owned DoFs, in the local numbering of @p src, right before the first cell batch reads them
+   * and @p operation_after(begin, end) right after the last cell batch has written to them. The
+   * entries of @p dst in a range still hold their previous values during @p operation_before
+   * and are zeroed afterwards. This lets solvers fuse their vector updates and dot products with
+   * the operator while the entries are in cache, see SolverCGFused. DoFs sent to or received
+   * from other processes, constrained DoFs and DoFs not touched by any cell are processed before
+   * and after the loop over the cell batches, which runs serially in the order of the batches.
+   */
+  void
+  vmult_fused(VectorType& dst, const VectorType& src,
+              const std::function<void(unsigned int, unsigned int)>& operation_before,
+              const std::function<void(unsigned int, unsigned int)>& operation_after) const
+  {
+    static_assert(!CFL::Traits::is_block_vector<VectorType>::value,
+                  "Fused vector operations are only implemented for non-block vectors!");
+    AssertThrow(!use_face && !use_boundary, dealii::ExcNotImplemented());
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    if (dof_ranges_before.empty())
+      setup_dof_ranges();
+    const unsigned int n_cell_batches = this->data->n_macro_cells();
+    const auto before = [&](const unsigned int batch) {
+      for (const auto& range : dof_ranges_before[batch])
+      {
+        operation_before(range.first, range.second);
+        for (unsigned int i = range.first; i < range.second; ++i)
+          dst.local_element(i) = Number(0.);
+      }
+    };
+    const auto after = [&](const unsigned int batch) {
+      for (const auto& range : dof_ranges_after[batch])
+        operation_after(range.first, range.second);
+    };
+
+    // the ranges processed outside the loop are stored after the ones of the cell batches
+    before(n_cell_batches);
+    std::vector<Number> edge_values;
+    if (!edge_constrained_dofs.empty())
+      for (const unsigned int i : edge_constrained_dofs[0])
+      {
+        Number& value = const_cast<VectorType&>(src).local_element(i);
+        edge_values.push_back(value);
+        value = Number(0.);
+      }
+    src.update_ghost_values();
+    dst.zero_out_ghosts();
+    const auto cell_operation = element_matrices.size() == 0
+                                  ? &MatrixFreeIntegratorBase::local_apply_cell
+                                  : &MatrixFreeIntegratorBase::local_apply_element_matrices;
+    for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+    {
+      before(cell);
+      (this->*cell_operation)(*this->data, dst, src, std::make_pair(cell, cell + 1));
+      after(cell);
+    }
+    dst.compress(dealii::VectorOperation::add);
+    src.zero_out_ghosts();
+
+    // constrained and edge entries are passed through from src as in vmult()
+    if (!edge_constrained_dofs.empty())
+      for (unsigned int j = 0; j < edge_constrained_dofs[0].size(); ++j)
+      {
+        const unsigned int i = edge_constrained_dofs[0][j];
+        const_cast<VectorType&>(src).local_element(i) = edge_values[j];
+        dst.local_element(i) = edge_values[j];
+      }
+    for (const unsigned int i : this->data->get_constrained_dofs())
+      dst.local_element(i) = src.local_element(i);
+    after(n_cell_batches);
+  }
+
+  /**
+   * The wall time of a few cell loops applying the cell terms with or without the element
+   * matrices, the maximum over all processes such that all of them choose the same variant.
+   */
+  double
+  time_cell_loop(const bool with_element_matrices)
+  {
+    constexpr unsigned int n_runs = 5;
+    dealii::AlignedVector<VectorizedArrayType> matrices;
+    if (!with_element_matrices)
+      matrices.swap(element_matrices);
+    const auto cell_operation = with_element_matrices
+                                  ? &MatrixFreeIntegratorBase::local_apply_element_matrices
+                                  : &MatrixFreeIntegratorBase::local_apply_cell;
+    VectorType src;
+    VectorType dst;
+    this->initialize_dof_vector(src);
+    this->initialize_dof_vector(dst);
+    src = Number(1.);
+    // the first run only warms up caches and thread local data
+    this->data->cell_loop(cell_operation, this, dst, src);
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int run = 0; run < n_runs; ++run)
+      this->data->cell_loop(cell_operation, this, dst, src);
+    const double time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!with_element_matrices)
+      matrices.swap(element_matrices);
+    if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+      return dealii::Utilities::MPI::max(time, src.block(0).get_mpi_communicator());
+    else
+      return dealii::Utilities::MPI::max(time, src.get_mpi_communicator());
+  }
+
+  // the position of the DoFs of each block in the element matrices and the blocks they couple
+  void
+  setup_element_matrix_layout()
+  {
+    element_matrix_size = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      const auto evaluation_flags = fe_datas->template get_evaluation_flags<b>();
+      const auto integration_flags = fe_datas->template get_integration_flags<b>();
+      AssertThrow(!evaluation_flags[2], dealii::ExcNotImplemented());
+      element_matrix_offsets[b] = element_matrix_size;
+      element_matrix_rows[b] = integration_flags[0] || integration_flags[1];
+      element_matrix_columns[b] = (evaluation_flags[0] || evaluation_flags[1]) && !is_bound(b);
+      element_matrix_size += n_block_dofs<b>();
+    });
+  }
+
+  /**
+   * The vector entries of block @p block accessed by lane @p lane of the cell batch @p cell, in
+   * the local numbering of the vector partitioner (locally owned first, then ghosts). They are
+   * taken from the DoFInfo of the MatrixFree object, i.e. after resolving the constraints like
+   * FEEvaluation::read_dof_values() does: DoFs constrained by hanging nodes are replaced by the
+   * DoFs constraining them, which may belong to other cells or processes, and DoFs without
+   * constraint entries (Dirichlet values) are left out.
+   */
+  void
+  get_resolved_dof_indices(const unsigned int cell, const unsigned int lane,
+                           const unsigned int block, std::vector<unsigned int>& indices) const
+  {
+    const auto& dof_info = this->data->get_dof_info(block);
+    // row_starts holds one entry per lane and base element component
+    const unsigned int n_components = dof_info.start_components.back();
+    const unsigned int row = cell * VectorizedArrayType::n_array_elements + lane;
+    indices.assign(dof_info.dof_indices.begin() + dof_info.row_starts[row * n_components].first,
+                   dof_info.dof_indices.begin() +
+                     dof_info.row_starts[(row + 1) * n_components].first);
+  }
+
+  /**
+   * Find the ranges of locally owned DoFs first read and last written by each cell batch, see
+   * vmult_fused(). The DoFs of a batch are the resolved ones of get_resolved_dof_indices(), so
+   * DoFs constraining hanging nodes are updated before the first batch reading them through
+   * the constraints. DoFs that are ghosts on other processes, constrained or not touched by any
+   * cell batch are assigned to the position n_cell_batches, i.e. processed outside the loop.
+   */
+  void
+  setup_dof_ranges() const
+  {
+    const auto& partitioner = this->data->get_vector_partitioner();
+    const unsigned int local_size = partitioner->local_size();
+    const unsigned int n_cell_batches = this->data->n_macro_cells();
+    std::vector<unsigned int> first_batch(local_size, n_cell_batches);
+    std::vector<unsigned int> last_batch(local_size, n_cell_batches);
+    std::vector<unsigned int> indices;
+    for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+      for (unsigned int lane = 0; lane < this->data->n_components_filled(cell); ++lane)
+        for (unsigned int b = 0; b < FEDatas::n; ++b)
+        {
+          get_resolved_dof_indices(cell, lane, b, indices);
+          for (const unsigned int i : indices)
+            if (i < local_size)
+            {
+              if (first_batch[i] == n_cell_batches)
+                first_batch[i] = cell;
+              last_batch[i] = cell;
+            }
+        }
+
+    const auto exclude = [&](const unsigned int i) {
+      first_batch[i] = n_cell_batches;
+      last_batch[i] = n_cell_batches;
+    };
+    for (const auto& range : partitioner->import_indices())
+      for (unsigned int i = range.first; i < range.second; ++i)
+        exclude(i);
+    for (const unsigned int i : this->data->get_constrained_dofs())
+      exclude(i);
+    for (const auto& dofs : edge_constrained_dofs)
+      for (const unsigned int i : dofs)
+        exclude(i);
+
+    // merge consecutive DoFs of the same batch into ranges
+    const auto make_ranges = [&](const std::vector<unsigned int>& batch_of_dof,
+                                 std::vector<std::vector<std::pair<unsigned int, unsigned int>>>&
+                                   ranges) {
+      ranges.assign(n_cell_batches + 1, {});
+      for (unsigned int i = 0; i < local_size; ++i)
+      {
+        auto& batch_ranges = ranges[batch_of_dof[i]];
+        if (!batch_ranges.empty() && batch_ranges.back().second == i)
+          ++batch_ranges.back().second;
+        else
+          batch_ranges.emplace_back(i, i + 1);
+      }
+    };
+    make_ranges(first_batch, dof_ranges_before);
+    make_ranges(last_batch, dof_ranges_after);
+  }
+
+  /**
+   * The global DoF indices of all lanes of cell batch @p cell, ordered like the rows of the
+   * element matrices, i.e. lane by lane and in each lane block by block in the lexicographic
+   * numbering of FEEvaluation. Lanes not filled are left out.
+   */
+  std::vector<dealii::types::global_dof_index>
+  get_element_dof_indices(FEDatas& phi, const unsigned int cell) const
+  {
+    const bool is_level =
+      this->data->get_level_mg_handler() != dealii::numbers::invalid_unsigned_int;
+    const unsigned int n_filled = this->data->n_components_filled(cell);
+    std::vector<dealii::types::global_dof_index> indices(n_filled * element_matrix_size);
+    std::vector<dealii::types::global_dof_index> cell_indices;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      if (!element_matrix_rows[b] && !element_matrix_columns[b])
+        return;
+      const auto& shape_info = phi.template get_fe_evaluation<b>().get_shape_info();
+      cell_indices.resize(n_block_dofs<b>());
+      for (unsigned int lane = 0; lane < n_filled; ++lane)
+      {
+        const auto cell_iterator = this->data->get_cell_iterator(cell, lane, b);
+        if (is_level)
+          cell_iterator->get_mg_dof_indices(cell_indices);
+        else
+          cell_iterator->get_dof_indices(cell_indices);
+        for (unsigned int i = 0; i < n_block_dofs<b>(); ++i)
+          indices[lane * element_matrix_size + element_matrix_offsets[b] + i] =
+            cell_indices[shape_info.lexicographic_numbering[i]];
+      }
+    });
+    return indices;
+  }
+
+  /**
+   * Compute the cell matrices of all cell batches and add them to the matrices
+   * get_matrix(row_block, column_block) using the constraints get_constraints(block). The cell
+   * batches are colored such that batches of the same color never write to the same matrix
+   * row, also through constraints, so WorkStream computes and distributes all batches of one
+   * color in parallel without locking.
+   */
+  template <typename MatrixGetter, typename ConstraintsGetter>
+  void
+  assemble_matrix(const MatrixGetter& get_matrix, const ConstraintsGetter& get_constraints)
+  {
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    AssertThrow(!use_face && !use_boundary, dealii::ExcNotImplemented());
+    update_bound_ghost_values();
+    setup_element_matrix_layout();
+    const unsigned int n = element_matrix_size;
+    const unsigned int n_cell_batches = this->data->n_macro_cells();
+
+    FEDatas& phi = get_fe_datas();
+    std::vector<std::vector<dealii::types::global_dof_index>> dof_indices(n_cell_batches);
+    for (unsigned int cell = 0; cell < n_cell_batches; ++cell)
+      dof_indices[cell] = get_element_dof_indices(phi, cell);
+
+    // the rows written by a cell batch, distinguished by block
+    const auto get_conflict_indices = [&](const unsigned int& cell) {
+      std::vector<dealii::types::global_dof_index> rows;
+      static_for_each<FEDatas::n>([&](auto block) {
+        constexpr unsigned int b = decltype(block)::value;
+        if (!element_matrix_rows[b])
+          return;
+        const dealii::ConstraintMatrix& constraints = get_constraints(b);
+        for (unsigned int lane = 0; lane < dof_indices[cell].size() / n; ++lane)
+          for (unsigned int i = 0; i < n_block_dofs<b>(); ++i)
+          {
+            const auto index = dof_indices[cell][lane * n + element_matrix_offsets[b] + i];
+            rows.push_back(index * FEDatas::n + b);
+            if (constraints.is_constrained(index))
+              for (const auto& entry : *constraints.get_constraint_entries(index))
+                rows.push_back(entry.first * FEDatas::n + b);
+          }
+      });
+      return rows;
+    };
+    const auto colored_cells = dealii::GraphColoring::make_graph_coloring(
+      0u,
+      n_cell_batches,
+      std::function<std::vector<dealii::types::global_dof_index>(const unsigned int&)>(
+        get_conflict_indices));
+
+    struct CopyData
+    {
+      unsigned int cell = 0;
+      dealii::AlignedVector<VectorizedArrayType> matrix;
+    };
+    const auto worker = [&](const unsigned int& cell, unsigned int& /*unused*/, CopyData& copy) {
+      FEDatas& phi = get_fe_datas();
+      phi.reinit(cell);
+      copy.cell = cell;
+      copy.matrix.resize_fast(n * n);
+      compute_element_matrix(phi, copy.matrix.begin());
+    };
+    const auto copier = [&](const CopyData& copy) {
+      const std::vector<dealii::types::global_dof_index>& indices = dof_indices[copy.cell];
+      for (unsigned int lane = 0; lane < indices.size() / n; ++lane)
+        static_for_each<FEDatas::n>([&](auto row_block) {
+          constexpr unsigned int r = decltype(row_block)::value;
+          if (!element_matrix_rows[r])
+            return;
+          const std::vector<dealii::types::global_dof_index> row_indices(
+            indices.begin() + lane * n + element_matrix_offsets[r],
+            indices.begin() + lane * n + element_matrix_offsets[r] + n_block_dofs<r>());
+          static_for_each<FEDatas::n>([&](auto column_block) {
+            constexpr unsigned int c = decltype(column_block)::value;
+            if (!element_matrix_columns[c])
+              return;
+            const std::vector<dealii::types::global_dof_index> column_indices(
+              indices.begin() + lane * n + element_matrix_offsets[c],
+              indices.begin() + lane * n + element_matrix_offsets[c] + n_block_dofs<c>());
+            auto& matrix = get_matrix(r, c);
+            dealii::FullMatrix<typename std::decay_t<decltype(matrix)>::value_type> local_matrix(
+              n_block_dofs<r>(), n_block_dofs<c>());
+            for (unsigned int i = 0; i < n_block_dofs<r>(); ++i)
+              for (unsigned int j = 0; j < n_block_dofs<c>(); ++j)
+                local_matrix(i, j) = copy.matrix[(element_matrix_offsets[r] + i) * n +
+                                                 element_matrix_offsets[c] + j][lane];
+            if (r == c)
+              get_constraints(r).distribute_local_to_global(local_matrix, row_indices, matrix);
+            else
+              get_constraints(r).distribute_local_to_global(
+                local_matrix, row_indices, get_constraints(c), column_indices, matrix);
+          });
+        });
+    };
+    unsigned int scratch = 0;
+    dealii::WorkStream::run(colored_cells, worker, copier, scratch, CopyData());
+  }
+
+  /**
+   * Compute the element matrix of the cell batch @p phi has been reinitialized to, row-wise
+   * with the DoFs of all blocks numbered consecutively, and store it at @p matrix. Column j is
+   * the response of the cell terms to a unit vector in DoF j, relative to their value at the
+   * linearization point. Rows of blocks not tested and columns of blocks not evaluated or bound
+   * to a vector are zero.
+   */
+  void
+  compute_element_matrix(FEDatas& phi, VectorizedArrayType* matrix) const
+  {
+    const unsigned int n = element_matrix_size;
+    VectorizedArrayType* reference = get_scratch(n);
+    std::fill(matrix, matrix + n * n, VectorizedArrayType());
+
+    // write the rows of the tested blocks of column @p j, relative to the reference
+    const auto store_column = [&](const unsigned int j) {
+      static_for_each<FEDatas::n>([&](auto block) {
+        constexpr unsigned int b = decltype(block)::value;
+        if (!element_matrix_rows[b])
+          return;
+        const VectorizedArrayType* values = phi.template get_fe_evaluation<b>().begin_dof_values();
+        const unsigned int offset = element_matrix_offsets[b];
+        for (unsigned int i = 0; i < n_block_dofs<b>(); ++i)
+          matrix[(offset + i) * n + j] = values[i] - reference[offset + i];
+      });
+    };
+
+    read_linearization(phi);
+    do_operation_on_cell(phi, 0);
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      if (element_matrix_rows[b])
+        std::copy_n(phi.template get_fe_evaluation<b>().begin_dof_values(),
+                    n_block_dofs<b>(),
+                    reference + element_matrix_offsets[b]);
+    });
+
+    VectorizedArrayType one;
+    one = Number(1.);
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      if (!element_matrix_columns[b])
+        return;
+      for (unsigned int j = 0; j < n_block_dofs<b>(); ++j)
+      {
+        read_linearization(phi);
+        phi.template get_fe_evaluation<b>().begin_dof_values()[j] += one;
+        do_operation_on_cell(phi, 0);
+        store_column(element_matrix_offsets[b] + j);
+      }
+    });
+  }
+
+  void local_element_matrices([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                              unsigned int& /*unused*/, const unsigned int& /*unused*/,
+                              const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    FEDatas& phi = get_fe_datas();
+    const std::size_t size = element_matrix_size * element_matrix_size;
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      compute_element_matrix(phi, element_matrices.begin() + cell * size);
+    }
+  }
+
+  /**
+   * Apply the cell terms to @p src and add the result to @p dst by multiplying the DoF values of
+   * the cell batch @p phi has been reinitialized to with its element matrix. Each lane of the
+   * VectorizedArray entries holds a different cell, so the dense matrix-vector product runs on
+   * full SIMD registers without any shuffling.
+   */
+  void
+  apply_element_matrix(FEDatas& phi, const unsigned int cell, VectorType& dst,
+                       const VectorType& src) const
+  {
+    const unsigned int n = element_matrix_size;
+    VectorizedArrayType* x = get_scratch(2 * n);
+    VectorizedArrayType* y = x + n;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      auto& fe_eval = phi.template get_fe_evaluation<b>();
+      VectorizedArrayType* x_block = x + element_matrix_offsets[b];
+      if (!element_matrix_columns[b])
+      {
+        std::fill(x_block, x_block + n_block_dofs<b>(), VectorizedArrayType());
+        return;
+      }
+      if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+        fe_eval.read_dof_values(src.block(b));
+      else
+        fe_eval.read_dof_values(src);
+      std::copy_n(fe_eval.begin_dof_values(), n_block_dofs<b>(), x_block);
+    });
+
+    const VectorizedArrayType* matrix =
+      element_matrices.begin() + static_cast<std::size_t>(cell) * n * n;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      VectorizedArrayType sum = VectorizedArrayType();
+      for (unsigned int j = 0; j < n; ++j)
+        sum += matrix[i * n + j] * x[j];
+      y[i] = sum;
+    }
+
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      if (element_matrix_rows[b])
+        std::copy_n(y + element_matrix_offsets[b],
+                    n_block_dofs<b>(),
+                    phi.template get_fe_evaluation<b>().begin_dof_values());
+    });
+    phi.distribute_local_to_global(dst);
+  }
+
+  void local_apply_element_matrices(
+    [[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+    const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    FEDatas& phi = get_fe_datas();
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
     {
-      /* Base<dim, Number>::data->face_loop (&MatrixFreeIntegrator::local_apply_face,
-                                             this, dst, src);*/
+      phi.reinit(cell);
+      apply_element_matrix(phi, cell, dst, src);
     }
-    if (use_boundary)
+  }
+
+  // the element matrix of a cell batch is loaded once for all vectors
+  void local_apply_element_matrices_multiple(
+    [[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, std::vector<VectorType>& dst,
+    const std::vector<VectorType>& src,
+    const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    FEDatas& phi = get_fe_datas();
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
     {
-      /* Base<dim, Number>::data->boundary_loop (&MatrixFreeIntegrator::local_apply_boundary,
-                                                 this, dst, src);*/
+      phi.reinit(cell);
+      for (unsigned int v = 0; v < src.size(); ++v)
+        apply_element_matrix(phi, cell, dst[v], src[v]);
     }
   }
 
@@ -103,13 +1395,50 @@ protected:
   {
     phi.evaluate();
     constexpr unsigned int n_q_points = FEEvaluation::get_n_q_points();
-    // static_for_old<0, n_q_points>()([&](int q)
-    for (unsigned int q = 0; q < n_q_points; ++q)
-      form->evaluate(phi, q);
+    {
+      PhaseCounters* counters = nullptr;
+      if constexpr(std::is_same<FEEvaluation, FEDatas>::value)
+        counters = phi.get_phase_counters();
+      const PhaseTimer timer(counters, 0, Phase::quadrature);
+      // static_for_old<0, n_q_points>()([&](int q)
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        form->evaluate(phi, q);
+    }
 
     phi.integrate();
   }
 
+  /**
+   * Reinitialize the FEDatas object of the calling thread to each cell batch in @p cell_range
+   * and pass it to @p apply, which reads, evaluates, integrates and distributes the vectors.
+   */
+  template <typename Operation>
+  void
+  apply_cell_batches(const std::pair<unsigned int, unsigned int>& cell_range,
+                     const Operation& apply) const
+  {
+    if constexpr(use_cell)
+    {
+      FEDatas& phi = get_fe_datas();
+#ifdef PHASE_COUNTERS
+      phi.set_phase_counters(get_phase_counters_of_thread());
+#endif
+      for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        phi.reinit(cell);
+        set_linearization_cache(phi, cell);
+        apply(phi);
+      }
+#ifdef PHASE_COUNTERS
+      phi.set_phase_counters(nullptr);
+#endif
+      if (!linearization_cache.empty())
+        static_for_each<FEDatas::n>([&](auto block) {
+          phi.template set_quadrature_data<decltype(block)::value>(nullptr);
+        });
+    }
+  }
+
   void local_apply_cell([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
                         VectorType& dst, const VectorType& src,
                         const std::pair<unsigned int, unsigned int>& cell_range) const
@@ -120,12 +1449,677 @@ protected:
       "This is only implemented for dealii::LinearAlgebra::distributed::Vector<Number> "
       "and dealii::LinearAlgebra::distributed::BlockVector<Number> objects!");
     Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    apply_cell_batches(cell_range, [&](FEDatas& phi) {
+      phi.read_dof_values(src);
+      do_operation_on_cell(phi, 0);
+      phi.distribute_local_to_global(dst);
+    });
+  }
+
+  /**
+   * Apply the cell terms to all vectors of @p src at once: each vector has its own FEDatas
+   * object, all of them are read and evaluated, then a single loop over the quadrature points
+   * evaluates the forms for every vector in turn, such that the Jacobian, JxW value, cell
+   * parameters and coefficients of a quadrature point are loaded into cache once for all
+   * vectors, and finally all vectors are integrated and distributed. Reading and distributing
+   * still go through FEEvaluation per vector, which decodes the DoF indices each time.
+   */
+  void local_apply_cell_multiple([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                                 std::vector<VectorType>& dst, const std::vector<VectorType>& src,
+                                 const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_cell)
+    {
+      const unsigned int n_vectors = src.size();
+      std::vector<std::shared_ptr<FEDatas>>& phis = get_fe_datas(n_vectors);
+      PhaseCounters* counters = nullptr;
+#ifdef PHASE_COUNTERS
+      counters = get_phase_counters_of_thread();
+      for (unsigned int v = 0; v < n_vectors; ++v)
+        phis[v]->set_phase_counters(counters);
+#endif
+      constexpr unsigned int n_q_points = FEDatas::get_n_q_points();
+      for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        for (unsigned int v = 0; v < n_vectors; ++v)
+        {
+          phis[v]->reinit(cell);
+          set_linearization_cache(*phis[v], cell);
+          phis[v]->read_dof_values(src[v]);
+          phis[v]->evaluate();
+        }
+        {
+          const PhaseTimer timer(counters, 0, Phase::quadrature);
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            for (unsigned int v = 0; v < n_vectors; ++v)
+              form->evaluate(*phis[v], q);
+        }
+        for (unsigned int v = 0; v < n_vectors; ++v)
+        {
+          phis[v]->integrate();
+          phis[v]->distribute_local_to_global(dst[v]);
+        }
+      }
+      for (unsigned int v = 0; v < n_vectors; ++v)
+      {
+#ifdef PHASE_COUNTERS
+        phis[v]->set_phase_counters(nullptr);
+#endif
+        if (!linearization_cache.empty())
+          static_for_each<FEDatas::n>([&](auto block) {
+            phis[v]->template set_quadrature_data<decltype(block)::value>(nullptr);
+          });
+      }
+    }
+  }
+
+  // let the cached blocks of @p phi read their quadrature point data from the cache
+  void
+  set_linearization_cache(FEDatas& phi, const unsigned int cell) const
+  {
+    if (linearization_cache.empty())
+      return;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      const std::size_t size = linearization_cache[b].size() / this->data->n_macro_cells();
+      if (size > 0)
+        phi.template set_quadrature_data<b>(linearization_cache[b].begin() + cell * size);
+    });
+  }
+
+  void local_linearization_cache([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                                 unsigned int& /*unused*/, const unsigned int& /*unused*/,
+                                 const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    FEDatas& phi = get_fe_datas();
     for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
     {
-      fe_datas->reinit(cell);
-      fe_datas->read_dof_values(src);
-      do_operation_on_cell(*fe_datas, cell);
-      fe_datas->distribute_local_to_global(dst);
+      phi.reinit(cell);
+      read_linearization(phi);
+      phi.evaluate();
+      static_for_each<FEDatas::n>([&](auto block) {
+        constexpr unsigned int b = decltype(block)::value;
+        const std::size_t size = linearization_cache[b].size() / this->data->n_macro_cells();
+        if (size > 0)
+          phi.template store_quadrature_data<b>(linearization_cache[b].begin() + cell * size);
+      });
+    }
+  }
+
+  // apply the face or boundary terms to the face batches in @p face_range for each vector
+  template <class FaceDatasType, typename DstType, typename SrcType>
+  void
+  apply_face_batches(FaceDatasType& phi, const std::pair<unsigned int, unsigned int>& face_range,
+                     DstType& dst, const SrcType& src) const
+  {
+    for (unsigned int face = face_range.first; face < face_range.second; ++face)
+    {
+      phi.reinit(face);
+      if constexpr(std::is_same<SrcType, VectorType>::value)
+      {
+        phi.read_dof_values(src);
+        do_operation_on_cell(phi, face);
+        phi.distribute_local_to_global(dst);
+      }
+      else
+        for (unsigned int v = 0; v < src.size(); ++v)
+        {
+          phi.read_dof_values(src[v]);
+          do_operation_on_cell(phi, face);
+          phi.distribute_local_to_global(dst[v]);
+        }
+    }
+  }
+
+  void local_apply_face([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                        VectorType& dst, const VectorType& src,
+                        const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_face)
+      apply_face_batches(get_face_datas(), face_range, dst, src);
+  }
+
+  void local_apply_face_multiple([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                                 std::vector<VectorType>& dst, const std::vector<VectorType>& src,
+                                 const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_face)
+      apply_face_batches(get_face_datas(), face_range, dst, src);
+  }
+
+  void local_apply_boundary([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                            VectorType& dst, const VectorType& src,
+                            const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_boundary)
+      apply_face_batches(get_boundary_datas(), face_range, dst, src);
+  }
+
+  void local_apply_boundary_multiple(
+    [[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, std::vector<VectorType>& dst,
+    const std::vector<VectorType>& src,
+    const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_boundary)
+      apply_face_batches(get_boundary_datas(), face_range, dst, src);
+  }
+
+  VectorizedArrayType*
+  get_scratch(const std::size_t size) const
+  {
+    dealii::AlignedVector<VectorizedArrayType>& scratch = scratch_pool.get();
+    if (scratch.size() < size)
+      scratch.resize_fast(size);
+    return scratch.begin();
+  }
+
+  template <unsigned int block>
+  using BlockFEData = std::decay_t<decltype(std::declval<FEDatas>().template get_fe_data<block>())>;
+
+  template <unsigned int block>
+  using BlockKernels = TensorProductKernels<dim, BlockFEData<block>::degree + 1,
+                                            BlockFEData<block>::n_q_points_1d, VectorizedArrayType>;
+
+  // value and reference derivatives in all coordinate directions
+  static constexpr unsigned int n_slots = dim + 1;
+
+  template <unsigned int block>
+  static constexpr unsigned int
+  n_block_dofs()
+  {
+    return BlockFEData<block>::n_fe_components * BlockKernels<block>::n_dofs;
+  }
+
+  template <unsigned int block>
+  static constexpr unsigned int
+  n_block_responses()
+  {
+    return BlockFEData<block>::n_fe_components * n_slots *
+           FEDatas::template get_n_q_points<block>();
+  }
+
+  void
+  update_bound_ghost_values() const
+  {
+    for (const BlockType* vector : bound_vectors)
+      if (vector != nullptr)
+        vector->update_ghost_values();
+  }
+
+  /**
+   * Set the DoF values of all blocks of @p phi, which is a FEDatas or FEFaceDatas object, to
+   * the state the operator is linearized around: bound blocks are read from their vectors,
+   * all other blocks are set to zero.
+   */
+  template <class FEEvaluation>
+  void
+  read_linearization(FEEvaluation& phi) const
+  {
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      if (!phi.template read_bound_dof_values<b>())
+        phi.template set_dof_values_to_zero<b>();
+    });
+  }
+
+  /**
+   * Probe the quadrature point operator defined by the form with respect to block @p block.
+   *
+   * The quadrature point data of all blocks is computed from the current DoF values, which
+   * have to be zero for block @p block. Then, for each input slot (component c_in, value or
+   * reference derivative s) used by the form, a unit field is written to block @p block in all
+   * quadrature points and the form is evaluated. Its response in block @p block, reduced by
+   * the response to a zero field, is passed to fn(c_in, s, response) with the layout
+   * response[(c_out * n_slots + l) * n_q_points + q]. Output slots not integrated by the form
+   * are zero.
+   */
+  template <unsigned int block, typename Fn>
+  void
+  probe_quadrature_operator(FEDatas& phi, VectorizedArrayType* scratch, const Fn& fn) const
+  {
+    constexpr unsigned int n_components = BlockFEData<block>::n_fe_components;
+    constexpr unsigned int n_q_points = FEDatas::template get_n_q_points<block>();
+    constexpr unsigned int n_responses = n_block_responses<block>();
+    auto& fe_eval = phi.template get_fe_evaluation<block>();
+    const auto evaluation_flags = phi.template get_evaluation_flags<block>();
+    const auto integration_flags = phi.template get_integration_flags<block>();
+    AssertThrow(!evaluation_flags[2], dealii::ExcNotImplemented());
+
+    VectorizedArrayType* zero_response = scratch;
+    VectorizedArrayType* response = scratch + n_responses;
+
+    const auto apply = [&](VectorizedArrayType* out, const unsigned int c_in,
+                           const unsigned int s) {
+      phi.evaluate();
+      if (s == 0)
+        for (unsigned int q = 0; q < n_q_points; ++q)
+          fe_eval.begin_values()[c_in * n_q_points + q] = Number(1.);
+      else if (s < n_slots)
+        for (unsigned int q = 0; q < n_q_points; ++q)
+          fe_eval.begin_gradients()[(c_in * dim + s - 1) * n_q_points + q] = Number(1.);
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        form->evaluate(phi, q);
+      for (unsigned int c_out = 0; c_out < n_components; ++c_out)
+        for (unsigned int l = 0; l < n_slots; ++l)
+        {
+          VectorizedArrayType* out_ptr = out + (c_out * n_slots + l) * n_q_points;
+          if (l == 0 && integration_flags[0])
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              out_ptr[q] = fe_eval.begin_values()[c_out * n_q_points + q];
+          else if (l > 0 && integration_flags[1])
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              out_ptr[q] = fe_eval.begin_gradients()[(c_out * dim + l - 1) * n_q_points + q];
+          else
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              out_ptr[q] = VectorizedArrayType();
+        }
+    };
+
+    // the response to a zero field, i.e. the affine part of the operator
+    apply(zero_response, 0, n_slots);
+    for (unsigned int c_in = 0; c_in < n_components; ++c_in)
+      for (unsigned int s = 0; s < n_slots; ++s)
+      {
+        if ((s == 0 && !evaluation_flags[0]) || (s > 0 && !evaluation_flags[1]))
+          continue;
+        apply(response, c_in, s);
+        for (unsigned int i = 0; i < n_responses; ++i)
+          response[i] -= zero_response[i];
+        fn(c_in, s, static_cast<const VectorizedArrayType*>(response));
+      }
+  }
+
+  /**
+   * Compute the diagonal of the cell matrix of block @p block. For a response to input slot s
+   * in output slot l, the diagonal entry i is sum_q C_ls(q) B_l(i,q) B_s(i,q). The products of
+   * tensor product basis functions factorize into elementwise products of the 1D shape
+   * matrices, so each contribution is a single sum factorization sweep.
+   */
+  template <unsigned int block>
+  void
+  compute_block_diagonal(FEDatas& phi, VectorizedArrayType* scratch,
+                         VectorizedArrayType* diagonal) const
+  {
+    using Kernels = BlockKernels<block>;
+    constexpr unsigned int n_entries_1d =
+      (BlockFEData<block>::degree + 1) * BlockFEData<block>::n_q_points_1d;
+    constexpr unsigned int n_q_points = FEDatas::template get_n_q_points<block>();
+    const auto& shape_info = phi.template get_fe_evaluation<block>().get_shape_info();
+    AssertDimension(shape_info.shape_values.size(), n_entries_1d);
+
+    std::array<VectorizedArrayType, n_entries_1d> value_value;
+    std::array<VectorizedArrayType, n_entries_1d> value_gradient;
+    std::array<VectorizedArrayType, n_entries_1d> gradient_gradient;
+    for (unsigned int i = 0; i < n_entries_1d; ++i)
+    {
+      value_value[i] = shape_info.shape_values[i] * shape_info.shape_values[i];
+      value_gradient[i] = shape_info.shape_values[i] * shape_info.shape_gradients[i];
+      gradient_gradient[i] = shape_info.shape_gradients[i] * shape_info.shape_gradients[i];
+    }
+
+    for (unsigned int i = 0; i < n_block_dofs<block>(); ++i)
+      diagonal[i] = VectorizedArrayType();
+
+    VectorizedArrayType* tmp0 = scratch + 2 * n_block_responses<block>();
+    VectorizedArrayType* tmp1 = tmp0 + Kernels::n_scratch;
+    probe_quadrature_operator<block>(
+      phi, scratch, [&](const unsigned int c, const unsigned int s, const auto* response) {
+        for (unsigned int l = 0; l < n_slots; ++l)
+        {
+          std::array<const VectorizedArrayType*, dim> matrices;
+          for (unsigned int d = 0; d < dim; ++d)
+          {
+            const unsigned int n_derivatives = (l == d + 1) + (s == d + 1);
+            if (n_derivatives == 0)
+              matrices[d] = value_value.data();
+            else if (n_derivatives == 1)
+              matrices[d] = value_gradient.data();
+            else
+              matrices[d] = gradient_gradient.data();
+          }
+          Kernels::integrate(matrices,
+                             response + (c * n_slots + l) * n_q_points,
+                             diagonal + c * Kernels::n_dofs,
+                             tmp0,
+                             tmp1);
+        }
+      });
+  }
+
+  /**
+   * Compute the cell matrix of block @p block, row-wise, column by column. For each trial
+   * function j the tensor product basis function is evaluated directly in the quadrature
+   * points, multiplied by the probed quadrature point operator and integrated against all test
+   * functions by sum factorization.
+   */
+  template <unsigned int block>
+  void
+  compute_block_matrix(FEDatas& phi, VectorizedArrayType* scratch,
+                       VectorizedArrayType* matrix) const
+  {
+    using Kernels = BlockKernels<block>;
+    constexpr unsigned int n_components = BlockFEData<block>::n_fe_components;
+    constexpr unsigned int n_q_points = FEDatas::template get_n_q_points<block>();
+    constexpr unsigned int n_responses = n_block_responses<block>();
+    constexpr unsigned int n_dofs = n_block_dofs<block>();
+    const auto& shape_info = phi.template get_fe_evaluation<block>().get_shape_info();
+
+    VectorizedArrayType* table = scratch + 2 * n_responses;
+    VectorizedArrayType* basis = table + n_components * n_slots * n_responses;
+    VectorizedArrayType* weight = basis + n_slots * n_q_points;
+    VectorizedArrayType* column = weight + n_q_points;
+    VectorizedArrayType* tmp0 = column + n_dofs;
+    VectorizedArrayType* tmp1 = tmp0 + Kernels::n_scratch;
+
+    for (unsigned int i = 0; i < n_components * n_slots * n_responses; ++i)
+      table[i] = VectorizedArrayType();
+    std::array<bool, n_slots> active_slots{};
+    probe_quadrature_operator<block>(
+      phi, scratch, [&](const unsigned int c, const unsigned int s, const auto* response) {
+        active_slots[s] = true;
+        std::copy(response, response + n_responses, table + (c * n_slots + s) * n_responses);
+      });
+
+    const auto slot_matrices = [&](const unsigned int slot) {
+      std::array<const VectorizedArrayType*, dim> matrices;
+      for (unsigned int d = 0; d < dim; ++d)
+        matrices[d] =
+          (slot == d + 1) ? shape_info.shape_gradients.begin() : shape_info.shape_values.begin();
+      return matrices;
+    };
+
+    for (unsigned int c_in = 0; c_in < n_components; ++c_in)
+      for (unsigned int j = 0; j < Kernels::n_dofs; ++j)
+      {
+        for (unsigned int s = 0; s < n_slots; ++s)
+          if (active_slots[s])
+            Kernels::evaluate_basis_function(slot_matrices(s), j, basis + s * n_q_points);
+        for (unsigned int i = 0; i < n_dofs; ++i)
+          column[i] = VectorizedArrayType();
+        for (unsigned int c_out = 0; c_out < n_components; ++c_out)
+          for (unsigned int l = 0; l < n_slots; ++l)
+          {
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              weight[q] = VectorizedArrayType();
+            for (unsigned int s = 0; s < n_slots; ++s)
+            {
+              if (!active_slots[s])
+                continue;
+              const VectorizedArrayType* coefficient =
+                table + (c_in * n_slots + s) * n_responses + (c_out * n_slots + l) * n_q_points;
+              for (unsigned int q = 0; q < n_q_points; ++q)
+                weight[q] += coefficient[q] * basis[s * n_q_points + q];
+            }
+            Kernels::integrate(
+              slot_matrices(l), weight, column + c_out * Kernels::n_dofs, tmp0, tmp1);
+          }
+        const unsigned int col = c_in * Kernels::n_dofs + j;
+        for (unsigned int i = 0; i < n_dofs; ++i)
+          matrix[i * n_dofs + col] = column[i];
+      }
+  }
+
+  // scratch entries needed by compute_block_diagonal
+  template <unsigned int block>
+  static constexpr std::size_t
+  n_diagonal_scratch()
+  {
+    return 2 * n_block_responses<block>() + 2 * BlockKernels<block>::n_scratch;
+  }
+
+  // scratch entries needed by compute_block_matrix
+  template <unsigned int block>
+  static constexpr std::size_t
+  n_matrix_scratch()
+  {
+    constexpr unsigned int n_q_points = FEDatas::template get_n_q_points<block>();
+    return 2 * n_block_responses<block>() +
+           BlockFEData<block>::n_fe_components * n_slots * n_block_responses<block>() +
+           (n_slots + 1) * n_q_points + n_block_dofs<block>() +
+           2 * BlockKernels<block>::n_scratch;
+  }
+
+  /**
+   * Compute the diagonal of the cell matrix for all blocks tested by the form and store it in
+   * the DoF values of these blocks. On entry, the DoF values define the linearization point.
+   */
+  void
+  compute_cell_diagonal(FEDatas& phi) const
+  {
+    std::size_t scratch_size = 0;
+    std::size_t diagonal_size = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      scratch_size = std::max(scratch_size, n_diagonal_scratch<b>());
+      diagonal_size += n_block_dofs<b>();
+    });
+    VectorizedArrayType* scratch = get_scratch(scratch_size + diagonal_size);
+    VectorizedArrayType* diagonals = scratch + scratch_size;
+
+    // all probes need the unmodified DoF values, so write back only at the end
+    std::size_t offset = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      const auto integration_flags = phi.template get_integration_flags<b>();
+      if (integration_flags[0] || integration_flags[1])
+        this->template compute_block_diagonal<b>(phi, scratch, diagonals + offset);
+      offset += n_block_dofs<b>();
+    });
+    offset = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      const auto integration_flags = phi.template get_integration_flags<b>();
+      if (integration_flags[0] || integration_flags[1])
+        std::copy(diagonals + offset,
+                  diagonals + offset + n_block_dofs<b>(),
+                  phi.template get_fe_evaluation<b>().begin_dof_values());
+      offset += n_block_dofs<b>();
+    });
+  }
+
+  void local_diagonal_cell([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                           VectorType& dst, const unsigned int& /*unused*/,
+                           const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_cell)
+    {
+      FEDatas& phi = get_fe_datas();
+      for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        phi.reinit(cell);
+        read_linearization(phi);
+        compute_cell_diagonal(phi);
+        phi.distribute_local_to_global(dst);
+      }
+    }
+  }
+
+  /**
+   * Compute the diagonal contributions of the face terms on the face batch @p phi has been
+   * reinitialized to and store them in its DoF values. Face matrices are not tensor products
+   * of 1D matrices, so the diagonal is found by applying the face operator to unit vectors,
+   * relative to its value at the linearization point.
+   */
+  template <class FaceDatasType>
+  void
+  compute_face_diagonal(FaceDatasType& phi) const
+  {
+    constexpr unsigned int n_sides = FaceDatasType::n_sides;
+    std::size_t size = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      size += n_sides * n_face_dofs<FaceDatasType, decltype(block)::value>();
+    });
+    VectorizedArrayType* reference = get_scratch(2 * size);
+    VectorizedArrayType* diagonals = reference + size;
+    std::fill(diagonals, diagonals + size, VectorizedArrayType());
+
+    read_linearization(phi);
+    do_operation_on_cell(phi, 0);
+    std::size_t offset = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      constexpr unsigned int n_dofs = n_face_dofs<FaceDatasType, b>();
+      const auto integration_flags = phi.template get_integration_flags<b>();
+      if (integration_flags[0] || integration_flags[1])
+        for (unsigned int side = 0; side < n_sides; ++side)
+          std::copy_n(phi.template get_fe_evaluation<b>(side).begin_dof_values(),
+                      n_dofs,
+                      reference + offset + side * n_dofs);
+      offset += n_sides * n_dofs;
+    });
+
+    VectorizedArrayType one;
+    one = Number(1.);
+    offset = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      constexpr unsigned int n_dofs = n_face_dofs<FaceDatasType, b>();
+      const auto evaluation_flags = phi.template get_evaluation_flags<b>();
+      const auto integration_flags = phi.template get_integration_flags<b>();
+      if ((evaluation_flags[0] || evaluation_flags[1]) &&
+          (integration_flags[0] || integration_flags[1]))
+        for (unsigned int side = 0; side < n_sides; ++side)
+          for (unsigned int i = 0; i < n_dofs; ++i)
+          {
+            read_linearization(phi);
+            phi.template get_fe_evaluation<b>(side).begin_dof_values()[i] += one;
+            do_operation_on_cell(phi, 0);
+            const std::size_t index = offset + side * n_dofs + i;
+            diagonals[index] =
+              phi.template get_fe_evaluation<b>(side).begin_dof_values()[i] - reference[index];
+          }
+      offset += n_sides * n_dofs;
+    });
+
+    offset = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      constexpr unsigned int b = decltype(block)::value;
+      constexpr unsigned int n_dofs = n_face_dofs<FaceDatasType, b>();
+      const auto integration_flags = phi.template get_integration_flags<b>();
+      if (integration_flags[0] || integration_flags[1])
+        for (unsigned int side = 0; side < n_sides; ++side)
+          std::copy_n(diagonals + offset + side * n_dofs,
+                      n_dofs,
+                      phi.template get_fe_evaluation<b>(side).begin_dof_values());
+      offset += n_sides * n_dofs;
+    });
+  }
+
+  template <class FaceDatasType, unsigned int block>
+  static constexpr unsigned int
+  n_face_dofs()
+  {
+    return FaceDatasType::template FEFaceEvaluationType<block>::tensor_dofs_per_cell;
+  }
+
+  void local_diagonal_face([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                           VectorType& dst, const unsigned int& /*unused*/,
+                           const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_face)
+    {
+      FaceDatas& phi = get_face_datas();
+      for (unsigned int face = face_range.first; face < face_range.second; ++face)
+      {
+        phi.reinit(face);
+        compute_face_diagonal(phi);
+        phi.distribute_local_to_global(dst);
+      }
+    }
+  }
+
+  void local_diagonal_boundary([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                               VectorType& dst, const unsigned int& /*unused*/,
+                               const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    if constexpr(use_boundary)
+    {
+      BoundaryDatas& phi = get_boundary_datas();
+      for (unsigned int face = face_range.first; face < face_range.second; ++face)
+      {
+        phi.reinit(face);
+        compute_face_diagonal(phi);
+        phi.distribute_local_to_global(dst);
+      }
+    }
+  }
+
+  void local_cell_block_diagonal([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
+                                 unsigned int& /*unused*/, const unsigned int& /*unused*/,
+                                 const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    FEDatas& phi = get_fe_datas();
+    std::size_t scratch_size = 0;
+    static_for_each<FEDatas::n>([&](auto block) {
+      scratch_size = std::max(scratch_size, n_matrix_scratch<decltype(block)::value>());
+    });
+    VectorizedArrayType* scratch = get_scratch(scratch_size);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      read_linearization(phi);
+      static_for_each<FEDatas::n>([&](auto block) {
+        constexpr unsigned int b = decltype(block)::value;
+        constexpr unsigned int n_dofs = n_block_dofs<b>();
+        if (cell_block_diagonal[b].size() > 0)
+          this->template compute_block_matrix<b>(
+            phi, scratch, cell_block_diagonal[b].begin() + cell * n_dofs * n_dofs);
+      });
+    }
+  }
+
+  /**
+   * Fill @p diagonal with the diagonal of the operator, computed cell by cell and face by face
+   * inside the matrix-free loop, and invert it in place. Constrained entries are set to one.
+   */
+  void
+  compute_inverse_diagonal(VectorType& diagonal) const
+  {
+    Assert((this->data != nullptr), dealii::ExcNotInitialized());
+    update_bound_ghost_values();
+    unsigned int dummy = 0;
+    this->initialize_dof_vector(diagonal);
+    if constexpr(use_face || use_boundary)
+      this->data->loop(&MatrixFreeIntegratorBase::local_diagonal_cell,
+                       &MatrixFreeIntegratorBase::local_diagonal_face,
+                       &MatrixFreeIntegratorBase::local_diagonal_boundary,
+                       this,
+                       diagonal,
+                       dummy);
+    else
+      this->data->cell_loop(
+        &MatrixFreeIntegratorBase::local_diagonal_cell, this, diagonal, dummy);
+    this->set_constrained_entries_to_one(diagonal);
+    if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+      {
+        for (unsigned int b = 0; b < diagonal.n_blocks(); ++b)
+          invert_diagonal(diagonal.block(b));
+      }
+    else
+      invert_diagonal(diagonal);
+  }
+
+  template <typename BlockType>
+  static void
+  invert_diagonal(BlockType& diagonal)
+  {
+    const unsigned int local_size = diagonal.local_size();
+    for (unsigned int i = 0; i < local_size; ++i)
+    {
+      if (std::abs(diagonal.local_element(i)) > std::sqrt(std::numeric_limits<Number>::epsilon()))
+        diagonal.local_element(i) = 1. / diagonal.local_element(i);
+      else
+        diagonal.local_element(i) = 1.;
     }
   }
 };
@@ -151,6 +2145,7 @@ public:
   {
     Base::Base::Base::initialize(data_, mg_constrained_dofs, level);
     initialize(form_, fe_datas_);
+    this->add_edge_constrained_dofs(mg_constrained_dofs, level, 0);
   }
 
   void
@@ -158,9 +2153,9 @@ public:
              const dealii::MGConstrainedDoFs& mg_constrained_dofs, const unsigned int level,
              const FORM& form_, FEDatas fe_datas_)
   {
-    Base::Base::Base::initialize(
-      std::make_shared<const dealii::MatrixFree<dim, Number>>(data_), mg_constrained_dofs, level);
+    Base::Base::Base::initialize(make_matrix_free_handle(data_), mg_constrained_dofs, level);
     initialize(form_, fe_datas_);
+    this->add_edge_constrained_dofs(mg_constrained_dofs, level, 0);
   }
 
   void
@@ -169,68 +2164,33 @@ public:
     Base::vmult(dst, src);
   }
 
+  /**
+   * Apply the operator to each vector of @p src, e.g. for several right hand sides or block
+   * eigensolvers, in a single loop over the cell batches, see vmult_multiple().
+   */
+  void
+  vmult(std::vector<VectorType>& dst, const std::vector<VectorType>& src) const
+  {
+    Base::vmult_multiple(dst, src);
+  }
+
+  // vmult() with vector operations fused into the cell loop, see vmult_fused()
+  void
+  vmult(VectorType& dst, const VectorType& src,
+        const std::function<void(unsigned int, unsigned int)>& operation_before,
+        const std::function<void(unsigned int, unsigned int)>& operation_after) const
+  {
+    Base::vmult_fused(dst, src, operation_before, operation_after);
+  }
+
   void
   compute_diagonal() override
   {
-    static_assert(FEDatas::n == 1, "This is for one compoennt!");
     Assert((Base::data != nullptr), dealii::ExcNotInitialized());
-    unsigned int dummy = 0;
     this->inverse_diagonal_entries.reset(new dealii::DiagonalMatrix<VectorType>());
     VectorType& inverse_diagonal_vector = this->inverse_diagonal_entries->get_vector();
-    this->initialize_dof_vector(inverse_diagonal_vector);
-    // VectorType ones;
-    // this->initialize_dof_vector(ones);
-    // ones = Number(1.);
-    // apply_add(inverse_diagonal_vector, ones);
-
-    this->data->cell_loop(
-      &MatrixFreeIntegrator::local_diagonal_cell, this, inverse_diagonal_vector, dummy);
-
-    this->set_constrained_entries_to_one(inverse_diagonal_vector);
-
-    const unsigned int local_size = inverse_diagonal_vector.local_size();
-    for (unsigned int i = 0; i < local_size; ++i)
-    {
-      if (std::abs(inverse_diagonal_vector.local_element(i)) >
-          std::sqrt(std::numeric_limits<Number>::epsilon()))
-      {
-        inverse_diagonal_vector.local_element(i) = 1. / inverse_diagonal_vector.local_element(i);
-      }
-      else
-        inverse_diagonal_vector.local_element(i) = 1.;
-    }
-
+    Base::compute_inverse_diagonal(inverse_diagonal_vector);
     inverse_diagonal_vector.update_ghost_values();
-    // inverse_diagonal_vector.print(std::cout);
-  }
-
-  // TODO(darndt): this is hacky and just tries to get comparable output w.r.t. step-37
-  void local_diagonal_cell([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
-                           VectorType& dst, const unsigned int& /*unused*/,
-                           const std::pair<unsigned int, unsigned int>& cell_range) const
-  {
-    Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
-    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
-    {
-      Base::fe_datas->reinit(cell);
-      const /*expr*/ unsigned int tensor_dofs_per_cell =
-        Base::fe_datas->template tensor_dofs_per_cell<0>();
-      std::vector<dealii::VectorizedArray<Number>> local_diagonal_vector(tensor_dofs_per_cell);
-
-      AssertThrow(data_.n_components() == 1, dealii::ExcNotImplemented());
-
-      for (unsigned int i = 0; i < Base::fe_datas->template dofs_per_cell<0>(); ++i)
-      {
-        for (unsigned int j = 0; j < Base::fe_datas->template dofs_per_cell<0>(); ++j)
-          Base::fe_datas->template begin_dof_values<0>()[j] = dealii::VectorizedArray<Number>();
-        Base::fe_datas->template begin_dof_values<0>()[i] = 1.;
-        Base::do_operation_on_cell(*Base::fe_datas, cell);
-        local_diagonal_vector[i] = Base::fe_datas->template begin_dof_values<0>()[i];
-      }
-      for (unsigned int i = 0; i < Base::fe_datas->template tensor_dofs_per_cell<0>(); ++i)
-        Base::fe_datas->template begin_dof_values<0>()[i] = local_diagonal_vector[i];
-      Base::fe_datas->distribute_local_to_global(dst);
-    }
   }
 };
 
@@ -253,6 +2213,8 @@ public:
   {
     Base::Base::Base::initialize(data_, mg_constrained_dofs, level);
     initialize(form_, fe_datas_);
+    for (unsigned int b = 0; b < mg_constrained_dofs.size(); ++b)
+      this->add_edge_constrained_dofs(mg_constrained_dofs[b], level, b);
   }
 
   void
@@ -260,56 +2222,67 @@ public:
              const std::vector<dealii::MGConstrainedDoFs>& mg_constrained_dofs,
              const unsigned int level, const FORM& form_, FEDatas fe_datas_)
   {
-    Base::Base::Base::initialize(
-      std::make_shared<const dealii::MatrixFree<dim, Number>>(data), mg_constrained_dofs, level);
+    Base::Base::Base::initialize(make_matrix_free_handle(data), mg_constrained_dofs, level);
     initialize(form_, fe_datas_);
+    for (unsigned int b = 0; b < mg_constrained_dofs.size(); ++b)
+      this->add_edge_constrained_dofs(mg_constrained_dofs[b], level, b);
   }
 
+  /**
+   * Bind the FEFunction objects of all blocks marked in @p nonlinear_components to the
+   * corresponding blocks of @p linearization_point, see bind_fe_function(). The vector is not
+   * copied, so it must not change while the operator is used.
+   */
   void
-  set_nonlinearities(std::vector<bool> nonlinear_components_,
-                     dealii::LinearAlgebra::distributed::BlockVector<Number> dst)
+  set_nonlinearities(const std::vector<bool>& nonlinear_components,
+                     const VectorType& linearization_point)
   {
-    nonlinear_components = nonlinear_components_;
-    safed_vectors.reinit(dst);
-    for (unsigned int i = 0; i < dst.n_blocks(); ++i)
-    {
-      AssertIndexRange(i, dst.n_blocks());
+    AssertDimension(nonlinear_components.size(), linearization_point.n_blocks());
+    this->unbind_fe_functions();
+    for (unsigned int i = 0; i < linearization_point.n_blocks(); ++i)
       if (nonlinear_components[i])
-        safed_vectors.block(i) = dst.block(i);
-    }
+        this->bind_fe_function(i, linearization_point.block(i));
+    this->update_linearization_cache();
+    this->update_element_matrices();
   }
 
+  // bound blocks are not read from @p src and passed through to @p dst
   void
-  vmult(dealii::LinearAlgebra::distributed::BlockVector<Number>& dst,
-        const dealii::LinearAlgebra::distributed::BlockVector<Number>& src) const
+  vmult(VectorType& dst, const VectorType& src) const
   {
-    if (nonlinear_components.empty())
-      Base::vmult(dst, src);
-    else
-    {
-      for (unsigned int i = 0; i < dst.n_blocks(); ++i)
-      {
-        if (!nonlinear_components[i])
-          safed_vectors.block(i) = src.block(i);
-      }
-      Base::vmult(dst, safed_vectors);
-      for (unsigned int i = 0; i < dst.n_blocks(); ++i)
-      {
-        if (nonlinear_components[i])
-          dst.block(i) = src.block(i);
-      }
-    }
+    Base::vmult(dst, src);
+    for (unsigned int i = 0; i < dst.n_blocks(); ++i)
+      if (this->is_bound(i))
+        dst.block(i) = src.block(i);
   }
 
+  /**
+   * Apply the operator to each vector of @p src in a single loop over the cell batches, see
+   * vmult_multiple(). Bound blocks are passed through as in vmult().
+   */
   void
-  compute_diagonal() override
+  vmult(std::vector<VectorType>& dst, const std::vector<VectorType>& src) const
   {
-    AssertThrow(false, dealii::ExcNotImplemented());
+    Base::vmult_multiple(dst, src);
+    for (unsigned int v = 0; v < dst.size(); ++v)
+      for (unsigned int i = 0; i < dst[v].n_blocks(); ++i)
+        if (this->is_bound(i))
+          dst[v].block(i) = src[v].block(i);
   }
 
-private:
-  std::vector<bool> nonlinear_components;
-  mutable VectorType safed_vectors;
+  void
+  compute_diagonal() override
+  {
+    Assert((Base::data != nullptr), dealii::ExcNotInitialized());
+    this->inverse_diagonal_entries.reset(new dealii::DiagonalMatrix<VectorType>());
+    VectorType& inverse_diagonal_vector = this->inverse_diagonal_entries->get_vector();
+    Base::compute_inverse_diagonal(inverse_diagonal_vector);
+    // bound blocks are passed through by vmult
+    for (unsigned int b = 0; b < inverse_diagonal_vector.n_blocks(); ++b)
+      if (this->is_bound(b))
+        inverse_diagonal_vector.block(b) = Number(1.);
+    inverse_diagonal_vector.update_ghost_values();
+  }
 };
 
 #endif // MATRIX_FREE_INTEGRATOR_H
@@ -69,7 +69,20 @@ public:
     dealii::deallog << dh_ptr_vector[fe.size() - 1]->n_dofs() << std::endl;
 
     mf = std::make_shared<dealii::MatrixFree<dim, double>>();
-    mf->reinit(mapping, dh_const_ptr_vector, constraint_const_ptr_vector, quadrature_vector);
+    typename dealii::MatrixFree<dim, double>::AdditionalData additional_data;
+    const dealii::UpdateFlags face_update_flags = dealii::update_values |
+                                                  dealii::update_gradients |
+                                                  dealii::update_JxW_values |
+                                                  dealii::update_normal_vectors;
+    if constexpr(Forms::has_face_forms)
+      additional_data.mapping_update_flags_inner_faces = face_update_flags;
+    if constexpr(Forms::has_boundary_forms)
+      additional_data.mapping_update_flags_boundary_faces = face_update_flags;
+    mf->reinit(mapping,
+               dh_const_ptr_vector,
+               constraint_const_ptr_vector,
+               quadrature_vector,
+               additional_data);
 
     integrator.initialize(mf, forms, fe_datas);
   }
@@ -21,8 +21,6 @@
  * 2009-2012, updated to MPI version with parallel vectors in 2016
  */
 
-//#include <dealii/mg_transfer_matrix_free.h>
-
 #include <deal.II/base/function.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/quadrature_lib.h>
@@ -61,9 +59,12 @@
 #include <sstream>
 
 #include <cfl/dealii_matrixfree.h>
+#include <cfl/dealii_matrixfree_linearize.h>
 #include <cfl/forms.h>
 #include <dealii/fe_data.h>
 #include <dealii/matrix_free_integrator.h>
+#include <dealii/mg_block_preconditioner.h>
+#include <dealii/solver_mixed_precision.h>
 
 constexpr unsigned int degree_finite_element = 3;
 constexpr unsigned int dimension = 2;
@@ -159,7 +160,8 @@ private:
   DoFHandler<dim> dof_handler;
 
   std::vector<ConstraintMatrix> constraints;
-  MatrixFree<dim, double> system_mf_storage;
+  // shared by system_matrix and rhs_operator
+  std::shared_ptr<MatrixFree<dim, double>> system_mf_storage;
   using SystemMatrixType =
     MatrixFreeIntegrator<dim, LinearAlgebra::distributed::BlockVector<double>, FormSystem,
                          FEDatasSystem>;
@@ -167,16 +169,20 @@ private:
   using RHSOperatorType = MatrixFreeIntegrator<dim, LinearAlgebra::distributed::BlockVector<double>,
                                                FormRHS, FEDatasSystem>;
   RHSOperatorType rhs_operator;
-
-  MGLevelObject<MatrixFree<dim, float>> mg_mf_storage;
-  using LevelMatrixType = MatrixFreeIntegrator<dim, LinearAlgebra::distributed::BlockVector<float>,
-                                               FormSystem, FEDatasLevel>;
-  MGLevelObject<LevelMatrixType> mg_matrices;
+  // the same form with the float FEDatas for the inner iterations of the mixed-precision solver
+  std::shared_ptr<MatrixFree<dim, float>> system_mf_storage_float;
+  using SystemMatrixFloatType =
+    MatrixFreeIntegrator<dim, LinearAlgebra::distributed::BlockVector<float>, FormSystem,
+                         FEDatasLevel>;
+  SystemMatrixFloatType system_matrix_float;
+
+  MGBlockPreconditioner<dim, FormSystem, FEDatasLevel> mg_preconditioner;
   std::vector<MGConstrainedDoFs> mg_constrained_dofs;
 
   LinearAlgebra::distributed::BlockVector<double> solution;
   LinearAlgebra::distributed::BlockVector<double> solution_update;
   LinearAlgebra::distributed::BlockVector<double> system_rhs;
+  LinearAlgebra::distributed::BlockVector<float> solution_float;
 
   double setup_time{};
   ConditionalOStream pcout;
@@ -218,8 +224,9 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::setup_sys
   setup_time = 0;
 
   system_matrix.clear();
+  system_matrix_float.clear();
   rhs_operator.clear();
-  mg_matrices.clear_elements();
+  mg_preconditioner.clear();
 
   dof_handler.distribute_dofs(*(mf_cfl_data_system.template get_fe_data<0>().fe));
   dof_handler.distribute_mg_dofs(*(mf_cfl_data_level.template get_fe_data<1>().fe));
@@ -249,7 +256,8 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::setup_sys
   time.restart();
   {
     typename MatrixFree<dim, double>::AdditionalData additional_data;
-    additional_data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim, double>::AdditionalData::partition_partition;
     additional_data.mapping_update_flags =
       (update_gradients | update_JxW_values | update_quadrature_points);
 
@@ -262,15 +270,28 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::setup_sys
 
     std::vector<QGauss<1>> quadrature_pointers(2, QGauss<1>(FEDatasSystem::max_degree + 1));
 
-    system_mf_storage.reinit(
+    system_mf_storage = std::make_shared<MatrixFree<dim, double>>();
+    system_mf_storage->reinit(
       dh_pointers, constraints_pointers, quadrature_pointers, additional_data);
+
+    typename MatrixFree<dim, float>::AdditionalData additional_data_float;
+    additional_data_float.tasks_parallel_scheme =
+      MatrixFree<dim, float>::AdditionalData::partition_partition;
+    additional_data_float.mapping_update_flags = additional_data.mapping_update_flags;
+    std::vector<QGauss<1>> quadrature_pointers_float(2, QGauss<1>(FEDatasLevel::max_degree + 1));
+
+    system_mf_storage_float = std::make_shared<MatrixFree<dim, float>>();
+    system_mf_storage_float->reinit(
+      dh_pointers, constraints_pointers, quadrature_pointers_float, additional_data_float);
   }
 
-  system_matrix.initialize(std::make_shared<MatrixFree<dim, double>>(system_mf_storage),
+  system_matrix.initialize(system_mf_storage,
                            std::make_shared<FormSystem>(form_system),
                            std::make_shared<FEDatasSystem>(mf_cfl_data_system));
+  // u is frozen during each linear solve, evaluate it only once per Newton step
+  system_matrix.enable_linearization_cache();
 
-  rhs_operator.initialize(std::make_shared<MatrixFree<dim, double>>(system_mf_storage),
+  rhs_operator.initialize(system_mf_storage,
                           std::make_shared<FormRHS>(form_rhs),
                           std::make_shared<FEDatasSystem>(mf_cfl_data_system));
 
@@ -278,6 +299,12 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::setup_sys
   system_matrix.initialize_dof_vector(system_rhs);
   system_matrix.initialize_dof_vector(solution_update);
 
+  system_matrix_float.initialize(system_mf_storage_float,
+                                 std::make_shared<FormSystem>(form_system),
+                                 std::make_shared<FEDatasLevel>(mf_cfl_data_level));
+  system_matrix_float.enable_linearization_cache();
+  system_matrix_float.initialize_dof_vector(solution_float);
+
   std::srand(std::time(nullptr));
   for (unsigned int i = 0; i < dof_handler.n_dofs(); ++i)
     solution(i) = ((2. * std::rand()) / RAND_MAX - 1.) * alpha;
@@ -289,54 +316,31 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::setup_sys
                << "s" << std::endl;
   time.restart();
 
-  const unsigned int nlevels = triangulation.n_global_levels();
-  mg_matrices.resize(0, nlevels - 1);
-  mg_mf_storage.resize(0, nlevels - 1);
-
   std::set<types::boundary_id> dirichlet_boundary{ 0, 1, 2, 3 };
   mg_constrained_dofs[0].initialize(dof_handler);
   mg_constrained_dofs[0].make_zero_boundary_constraints(dof_handler, dirichlet_boundary);
   mg_constrained_dofs[1].initialize(dof_handler);
 
-  for (unsigned int level = 0; level < nlevels; ++level)
-  {
-    IndexSet relevant_dofs;
-    DoFTools::extract_locally_relevant_level_dofs(dof_handler, level, relevant_dofs);
-    std::vector<ConstraintMatrix> level_constraints(2);
-    level_constraints[0].reinit(relevant_dofs);
-    level_constraints[0].add_lines(mg_constrained_dofs[0].get_boundary_indices(level));
-    level_constraints[0].close();
-    level_constraints[1].reinit(relevant_dofs);
-    //    level_constraints[1].add_lines(mg_constrained_dofs[1].get_boundary_indices(level));
-    level_constraints[1].close();
-
-    typename MatrixFree<dim, float>::AdditionalData additional_data;
-    additional_data.tasks_parallel_scheme = MatrixFree<dim, float>::AdditionalData::none;
-    additional_data.mapping_update_flags =
-      (update_gradients | update_JxW_values | update_quadrature_points);
-    additional_data.level_mg_handler = level;
-
-    std::vector<const DoFHandler<dim>*> dh_pointers;
-    dh_pointers.push_back(&dof_handler);
-    dh_pointers.push_back(&dof_handler);
-    std::vector<const ConstraintMatrix*> constraints_pointers;
-    constraints_pointers.push_back(&(level_constraints[0]));
-    constraints_pointers.push_back(&(level_constraints[1]));
-
-    std::vector<QGauss<1>> quadrature_pointers(2, QGauss<1>(FEDatasLevel::max_degree + 1));
-
-    mg_mf_storage[level].reinit(
-      dh_pointers, constraints_pointers, quadrature_pointers, additional_data);
-
-    mg_matrices[level].initialize(std::make_shared<MatrixFree<dim, float>>(mg_mf_storage[level]),
-                                  mg_constrained_dofs,
-                                  level,
-                                  std::make_shared<FormSystem>(form_system),
-                                  std::make_shared<FEDatasLevel>(mf_cfl_data_level));
-  }
+  mg_preconditioner.initialize(
+    { &dof_handler, &dof_handler }, mg_constrained_dofs, form_system, mf_cfl_data_level);
   setup_time += time.wall_time();
   time_details << "Setup matrix-free levels   (CPU/wall) " << time() << "s/" << time.wall_time()
                << "s" << std::endl;
+
+  // the MatrixFree objects are shared, so they are counted once and not per operator
+  const std::size_t mf_memory =
+    system_mf_storage->memory_consumption() + system_mf_storage_float->memory_consumption();
+  const std::size_t operator_memory = system_matrix.memory_consumption() +
+                                      system_matrix_float.memory_consumption() +
+                                      rhs_operator.memory_consumption();
+  const std::size_t mg_memory = mg_preconditioner.memory_consumption();
+  pcout << "Memory MatrixFree              (MB) "
+        << Utilities::MPI::sum(static_cast<double>(mf_memory), MPI_COMM_WORLD) / 1e6 << "\n"
+        << "Memory operators               (MB) "
+        << Utilities::MPI::sum(static_cast<double>(operator_memory), MPI_COMM_WORLD) / 1e6 << "\n"
+        << "Memory multigrid levels        (MB) "
+        << Utilities::MPI::sum(static_cast<double>(mg_memory), MPI_COMM_WORLD) / 1e6
+        << std::endl;
 }
 
 template <int dim, class FEDatasSystem, class FEDatasLevel, class FormSystem, class FormRHS>
@@ -409,61 +413,20 @@ double
 LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::solve()
 {
   Timer time;
-  /*  MGTransferBlockMatrixFree<dim, float> mg_transfer(mg_constrained_dofs);
-    mg_transfer.build_matrices(dof_handler);*/
-  /*    setup_time += time.wall_time();
-      time_details << "MG build transfer time     (CPU/wall) " << time() << "s/" << time.wall_time()
-                   << "s\n";
-      time.restart();
-
-      typedef PreconditionChebyshev<LevelMatrixType, LinearAlgebra::distributed::BlockVector<float>>
-        SmootherType;
-      mg::SmootherRelaxation<SmootherType, LinearAlgebra::distributed::BlockVector<float>>
-      mg_smoother;
-      MGLevelObject<typename SmootherType::AdditionalData> smoother_data;
-      smoother_data.resize(0, triangulation.n_global_levels() - 1);
-      for (unsigned int level = 0; level < triangulation.n_global_levels(); ++level)
-      {
-        if (level > 0)
-        {
-          smoother_data[level].smoothing_range = 15.;
-          smoother_data[level].degree = 4;
-          smoother_data[level].eig_cg_n_iterations = 10;
-        }
-        else
-        {
-          smoother_data[0].smoothing_range = 1e-3;
-          smoother_data[0].degree = numbers::invalid_unsigned_int;
-          smoother_data[0].eig_cg_n_iterations = mg_matrices[0].m();
-        }
-        mg_matrices[level].compute_diagonal();
-        //smoother_data[level].preconditioner = mg_matrices[level].get_matrix_diagonal_inverse();
-      }
-      mg_smoother.initialize(mg_matrices, smoother_data);
-
-      MGCoarseGridApplySmoother<LinearAlgebra::distributed::BlockVector<float>> mg_coarse;
-      mg_coarse.initialize(mg_smoother);
-
-      mg::Matrix<LinearAlgebra::distributed::BlockVector<float>> mg_matrix(mg_matrices);
-
-      MGLevelObject<MatrixFreeOperators::MGInterfaceOperator<LevelMatrixType>>
-     mg_interface_matrices;
-      mg_interface_matrices.resize(0, triangulation.n_global_levels() - 1);
-      for (unsigned int level = 0; level < triangulation.n_global_levels(); ++level)
-        mg_interface_matrices[level].initialize(mg_matrices[level]);
-      mg::Matrix<LinearAlgebra::distributed::BlockVector<float>>
-     mg_interface(mg_interface_matrices);
-
-      Multigrid<LinearAlgebra::distributed::BlockVector<float>> mg(
-        mg_matrix, mg_coarse, mg_transfer, mg_smoother, mg_smoother);
-      mg.set_edge_matrices(mg_interface, mg_interface);
+  // set nonlinearity to use
+  solution.block(1) = solution.block(0);
+  std::vector<bool> nonlinear_components;
+  nonlinear_components.push_back(false);
+  nonlinear_components.push_back(true);
 
-      PreconditionMG<dim, LinearAlgebra::distributed::BlockVector<float>,
-      MGTransferPrebuilt<LinearAlgebra::distributed::BlockVector<float> > >
-        preconditioner(dof_handler, mg, mg_transfer);*/
+  // the level operators are linearized at u interpolated to the levels in float
+  mg_preconditioner.set_nonlinearities(nonlinear_components, solution);
 
-  SolverControl solver_control(dof_handler.n_dofs(), 1e-12 * system_rhs.l2_norm(), false, false);
-  SolverCG<LinearAlgebra::distributed::BlockVector<double>> cg(solver_control);
+  // outer steps of the iterative refinement, each reduces the residual by about the inner reduction
+  SolverControl solver_control(100, 1e-12 * system_rhs.l2_norm(), false, false);
+  SolverMixedPrecision<LinearAlgebra::distributed::BlockVector<double>,
+                       LinearAlgebra::distributed::BlockVector<float>>
+    solver(solver_control);
   setup_time += time.wall_time();
   time_details << "MG build smoother time     (CPU/wall) " << time() << "s/" << time.wall_time()
                << "s\n";
@@ -472,14 +435,11 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::solve()
   time.reset();
   time.start();
 
-  // set nonlinearity to use
-  solution.block(1) = solution.block(0);
-  std::vector<bool> nonlinear_components;
-  nonlinear_components.push_back(false);
-  nonlinear_components.push_back(true);
   system_matrix.set_nonlinearities(nonlinear_components, solution);
+  solution_float = solution;
+  system_matrix_float.set_nonlinearities(nonlinear_components, solution_float);
 
-  cg.solve(system_matrix, solution_update, system_rhs, /*preconditioner*/ PreconditionIdentity());
+  solver.solve(system_matrix, system_matrix_float, solution_update, system_rhs, mg_preconditioner);
 
   constraints[0].distribute(solution_update.block(0));
   const double b = .2;
@@ -488,8 +448,9 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::solve()
   pcout << "update: " << solution_update.l2_norm() << std::endl;
   pcout << "solution: " << solution.l2_norm() << std::endl;
 
-  pcout << "Time solve (" << solver_control.last_step() << " iterations)  (CPU/wall) " << time()
-        << "s/" << time.wall_time() << "s\n";
+  pcout << "Time solve (" << solver_control.last_step() << " outer, "
+        << solver.get_n_inner_iterations() << " inner iterations)  (CPU/wall) " << time() << "s/"
+        << time.wall_time() << "s\n";
   return solution_update.l2_norm();
 }
 
@@ -563,7 +524,7 @@ main(int argc, char* argv[])
   {
     using namespace Step37;
 
-    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, numbers::invalid_unsigned_int);
 
     FE_Q<dimension> fe_u(degree_finite_element);
     const auto fe_shared = std::make_shared<FE_Q<dimension>>(fe_u);
@@ -581,16 +542,12 @@ main(int argc, char* argv[])
 
     CFL::dealii::MatrixFree::TestFunction<0, dimension, 0> v;
     auto Dv = grad(v);
-    CFL::dealii::MatrixFree::FEFunction<0, dimension, 0> e("e");
-    auto De = grad(e);
     CFL::dealii::MatrixFree::FEFunction<0, dimension, 1> u("u");
     auto Du = grad(u);
 
-    auto f1 = CFL::form(De, Dv);
-    auto f2 = CFL::form(3 * u * u * e - alpha * e, v);
-    auto f = f1 + f2;
-
     auto rhs = CFL::form(-Du, Dv) + CFL::form(-u * u * u + alpha * u, v);
+    // the Jacobian (De, Dv) + (3*u*u*e - alpha*e, v) with the increment e in block 0
+    auto f = CFL::dealii::MatrixFree::linearize<1, 0>(-rhs);
 
     LaplaceProblem<dimension,
                    decltype(fe_datas_system),
@@ -0,0 +1,361 @@
+#ifndef MG_BLOCK_PRECONDITIONER_H
+#define MG_BLOCK_PRECONDITIONER_H
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <dealii/matrix_free_integrator.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * A geometric multigrid preconditioner for the block system given by a CFL form, built from
+ * the form and the FEDatas of the levels, usually with float numbers. For each level, a
+ * MatrixFree object on the level DoFs of all blocks and a MatrixFreeIntegrator are set up, with
+ * the boundary DoFs of the MGConstrainedDoFs of each block constrained to zero. The levels are
+ * connected by MGTransferBlockMatrixFree. Pre- and post-smoothing is done by Chebyshev
+ * iterations around the inverse diagonal of the level operators, the coarse level is solved by
+ * a Chebyshev iteration of high degree.
+ *
+ * Blocks bound to a vector on the levels are passed through by the level operators, see
+ * set_nonlinearities() and set_level_nonlinearities(). Forms with CellParameter terminals need
+ * their values on all levels from set_cell_parameter(), Coefficient terminals can be cached on
+ * all levels by cache_coefficient(). The smoothers are only set up once the level operators are
+ * complete, by set_nonlinearities(), set_level_nonlinearities() or update_smoothers().
+ */
+template <int dim, class FORM, class FEDatas>
+class MGBlockPreconditioner
+{
+public:
+  using Number = typename FEDatas::NumberType;
+  using VectorType = dealii::LinearAlgebra::distributed::BlockVector<Number>;
+  using LevelMatrixType = MatrixFreeIntegrator<dim, VectorType, FORM, FEDatas>;
+  using SmootherType = dealii::PreconditionChebyshev<LevelMatrixType, VectorType>;
+  using TransferType = dealii::MGTransferBlockMatrixFree<dim, Number>;
+
+  struct AdditionalData
+  {
+    // the Chebyshev smoothers on all levels but the coarsest
+    unsigned int smoothing_degree = 4;
+    double smoothing_range = 15.;
+    unsigned int eig_cg_n_iterations = 10;
+    dealii::UpdateFlags mapping_update_flags =
+      dealii::update_gradients | dealii::update_JxW_values | dealii::update_quadrature_points;
+  };
+
+  MGBlockPreconditioner() = default;
+
+  MGBlockPreconditioner(const MGBlockPreconditioner&) = delete;
+
+  MGBlockPreconditioner&
+  operator=(const MGBlockPreconditioner&) = delete;
+
+  ~MGBlockPreconditioner()
+  {
+    clear();
+  }
+
+  /**
+   * Set up the level operators of @p form for the blocks given by @p dof_handlers and the
+   * transfer between the levels. The DoFHandlers need distributed level DoFs and have to
+   * outlive this object.
+   */
+  void
+  initialize(const std::vector<const dealii::DoFHandler<dim>*>& dof_handlers_,
+             const std::vector<dealii::MGConstrainedDoFs>& mg_constrained_dofs_,
+             const FORM& form, const FEDatas& fe_datas,
+             const AdditionalData& additional_data_ = AdditionalData())
+  {
+    AssertDimension(dof_handlers_.size(), mg_constrained_dofs_.size());
+    clear();
+    dof_handlers = dof_handlers_;
+    mg_constrained_dofs = mg_constrained_dofs_;
+    additional_data = additional_data_;
+
+    n_levels = dof_handlers[0]->get_triangulation().n_global_levels();
+    level_data.resize(0, n_levels - 1);
+    level_matrices.resize(0, n_levels - 1);
+    for (unsigned int level = 0; level < n_levels; ++level)
+    {
+      std::vector<dealii::ConstraintMatrix> level_constraints(dof_handlers.size());
+      std::vector<const dealii::ConstraintMatrix*> constraints_pointers;
+      for (unsigned int b = 0; b < dof_handlers.size(); ++b)
+      {
+        dealii::IndexSet relevant_dofs;
+        dealii::DoFTools::extract_locally_relevant_level_dofs(
+          *dof_handlers[b], level, relevant_dofs);
+        level_constraints[b].reinit(relevant_dofs);
+        if (mg_constrained_dofs[b].have_boundary_indices())
+          level_constraints[b].add_lines(mg_constrained_dofs[b].get_boundary_indices(level));
+        level_constraints[b].close();
+        constraints_pointers.push_back(&level_constraints[b]);
+      }
+
+      typename dealii::MatrixFree<dim, Number>::AdditionalData mf_additional_data;
+      mf_additional_data.tasks_parallel_scheme =
+        dealii::MatrixFree<dim, Number>::AdditionalData::partition_partition;
+      mf_additional_data.mapping_update_flags = additional_data.mapping_update_flags;
+      mf_additional_data.level_mg_handler = level;
+      const std::vector<dealii::QGauss<1>> quadratures(
+        dof_handlers.size(), dealii::QGauss<1>(FEDatas::max_degree + 1));
+
+      level_data[level] = std::make_shared<dealii::MatrixFree<dim, Number>>();
+      level_data[level]->reinit(dof_handlers, constraints_pointers, quadratures,
+                                mf_additional_data);
+      level_matrices[level].initialize(level_data[level],
+                                       mg_constrained_dofs,
+                                       level,
+                                       std::make_shared<FORM>(form),
+                                       std::make_shared<FEDatas>(fe_datas));
+    }
+
+    transfer.initialize_constraints(mg_constrained_dofs);
+    transfer.build(dof_handlers);
+  }
+
+  /**
+   * Set the values of the CellParameter objects with index @p index on all levels, see
+   * MatrixFreeIntegratorBase::set_cell_parameter(). @p level_values[level] holds one value per
+   * cell of the level, indexed by CellAccessor::index(), e.g. computed from the material ids of
+   * the level cells. Has to be called after each initialize() and before the smoothers are set
+   * up, since the diagonals depend on the parameters.
+   */
+  template <typename OtherNumber>
+  void
+  set_cell_parameter(const unsigned int index,
+                     const dealii::MGLevelObject<dealii::Vector<OtherNumber>>& level_values)
+  {
+    Assert(n_levels > 0, dealii::ExcNotInitialized());
+    AssertDimension(level_values.max_level() + 1, n_levels);
+    for (unsigned int level = 0; level < n_levels; ++level)
+      level_matrices[level].set_cell_parameter(index, level_values[level]);
+  }
+
+  /**
+   * Evaluate @p coefficient once in the quadrature points of all levels and keep the values
+   * in the level operators, see MatrixFreeIntegratorBase::cache_coefficient(). Otherwise the
+   * level operators call its function in every quadrature point. Has to be called after each
+   * initialize().
+   */
+  template <class CoefficientType>
+  void
+  cache_coefficient(const CoefficientType& coefficient)
+  {
+    Assert(n_levels > 0, dealii::ExcNotInitialized());
+    for (unsigned int level = 0; level < n_levels; ++level)
+      level_matrices[level].cache_coefficient(coefficient);
+  }
+
+  /**
+   * Interpolate the blocks marked in @p nonlinear_components of the fine level vector
+   * @p linearization_point, e.g. the current Newton iterate, to all levels and bind them to the
+   * level operators, see set_level_nonlinearities(). The level vectors are stored here in the
+   * number type of the levels and overwritten by the next call, so this is meant to be called
+   * once per Newton step, without setting up the level MatrixFree objects again. The values
+   * are interpolated by MGTransferMatrixFree::interpolate_to_mg() without the boundary
+   * constraints of the blocks, since they are coefficients rather than unknowns.
+   */
+  template <typename OtherVectorType>
+  void
+  set_nonlinearities(const std::vector<bool>& nonlinear_components,
+                     const OtherVectorType& linearization_point)
+  {
+    AssertDimension(nonlinear_components.size(), dof_handlers.size());
+    if (interpolation_transfers.empty())
+    {
+      interpolation_transfers.resize(dof_handlers.size());
+      level_linearization_points.resize(0, n_levels - 1);
+      for (unsigned int level = 0; level < n_levels; ++level)
+        level_matrices[level].initialize_dof_vector(level_linearization_points[level]);
+    }
+
+    dealii::MGLevelObject<dealii::LinearAlgebra::distributed::Vector<Number>> level_block(
+      0, n_levels - 1);
+    for (unsigned int b = 0; b < dof_handlers.size(); ++b)
+      if (nonlinear_components[b])
+      {
+        if (!interpolation_transfers[b])
+        {
+          interpolation_transfers[b] =
+            std::make_unique<dealii::MGTransferMatrixFree<dim, Number>>();
+          interpolation_transfers[b]->build(*dof_handlers[b]);
+        }
+        interpolation_transfers[b]->interpolate_to_mg(
+          *dof_handlers[b], level_block, linearization_point.block(b));
+        // keeps the ghost layout of the level operators, only the owned values are copied
+        for (unsigned int level = 0; level < n_levels; ++level)
+          level_linearization_points[level].block(b) = level_block[level];
+      }
+    set_level_nonlinearities(nonlinear_components, level_linearization_points);
+  }
+
+  /**
+   * Bind the blocks marked in @p nonlinear_components of the level operators to the level
+   * vectors @p level_linearization_points, see MatrixFreeIntegrator::set_nonlinearities(), and
+   * set up the smoothers for the new level operators. The vectors are not copied.
+   */
+  void
+  set_level_nonlinearities(const std::vector<bool>& nonlinear_components,
+                           const dealii::MGLevelObject<VectorType>& level_linearization_points)
+  {
+    for (unsigned int level = 0; level < n_levels; ++level)
+      level_matrices[level].set_nonlinearities(nonlinear_components,
+                                               level_linearization_points[level]);
+    update_smoothers();
+  }
+
+  /**
+   * Compute the diagonals of the level operators and set up the smoothers, the coarse solver
+   * and the multigrid cycle. Has to be called whenever the level operators changed.
+   */
+  void
+  update_smoothers()
+  {
+    Assert(n_levels > 0, dealii::ExcNotInitialized());
+    preconditioner.reset();
+    multigrid.reset();
+
+    smoother_data.resize(0, n_levels - 1);
+    for (unsigned int level = 0; level < n_levels; ++level)
+    {
+      if (level > 0)
+      {
+        smoother_data[level].smoothing_range = additional_data.smoothing_range;
+        smoother_data[level].degree = additional_data.smoothing_degree;
+        smoother_data[level].eig_cg_n_iterations = additional_data.eig_cg_n_iterations;
+      }
+      else
+      {
+        smoother_data[0].smoothing_range = 1e-3;
+        smoother_data[0].degree = dealii::numbers::invalid_unsigned_int;
+        smoother_data[0].eig_cg_n_iterations = level_matrices[0].m();
+      }
+      level_matrices[level].compute_diagonal();
+      smoother_data[level].preconditioner = level_matrices[level].get_matrix_diagonal_inverse();
+    }
+    mg_smoother.initialize(level_matrices, smoother_data);
+    mg_coarse.initialize(mg_smoother);
+    mg_matrix.initialize(level_matrices);
+    interface_matrices.resize(0, n_levels - 1);
+    for (unsigned int level = 0; level < n_levels; ++level)
+      interface_matrices[level].initialize(level_matrices[level]);
+    mg_interface.initialize(interface_matrices);
+
+    multigrid = std::make_unique<dealii::Multigrid<VectorType>>(
+      mg_matrix, mg_coarse, transfer, mg_smoother, mg_smoother);
+    multigrid->set_edge_matrices(mg_interface, mg_interface);
+    preconditioner =
+      std::make_unique<dealii::PreconditionMG<dim, VectorType, TransferType>>(
+        dof_handlers, *multigrid, transfer);
+  }
+
+  // one V-cycle, @p dst and @p src may have another number type than the levels
+  template <typename OtherVectorType>
+  void
+  vmult(OtherVectorType& dst, const OtherVectorType& src) const
+  {
+    Assert(preconditioner != nullptr, dealii::ExcNotInitialized());
+    preconditioner->vmult(dst, src);
+  }
+
+  void
+  clear()
+  {
+    preconditioner.reset();
+    multigrid.reset();
+    mg_interface.reset();
+    mg_matrix.reset();
+    mg_coarse.clear();
+    mg_smoother.clear();
+    interface_matrices.resize(0, 0);
+    level_matrices.resize(0, 0);
+    level_data.resize(0, 0);
+    level_linearization_points.resize(0, 0);
+    interpolation_transfers.clear();
+    n_levels = 0;
+  }
+
+  unsigned int
+  get_n_levels() const
+  {
+    return n_levels;
+  }
+
+  LevelMatrixType&
+  get_level_matrix(const unsigned int level)
+  {
+    AssertIndexRange(level, n_levels);
+    return level_matrices[level];
+  }
+
+  const LevelMatrixType&
+  get_level_matrix(const unsigned int level) const
+  {
+    AssertIndexRange(level, n_levels);
+    return level_matrices[level];
+  }
+
+  const TransferType&
+  get_transfer() const
+  {
+    return transfer;
+  }
+
+  // the level MatrixFree objects, operators and linearization points and the transfers
+  std::size_t
+  memory_consumption() const
+  {
+    std::size_t memory = transfer.memory_consumption();
+    for (unsigned int level = 0; level < n_levels; ++level)
+      memory +=
+        level_data[level]->memory_consumption() + level_matrices[level].memory_consumption();
+    if (!interpolation_transfers.empty())
+      for (unsigned int level = 0; level < n_levels; ++level)
+        memory += level_linearization_points[level].memory_consumption();
+    for (const auto& interpolation_transfer : interpolation_transfers)
+      if (interpolation_transfer)
+        memory += interpolation_transfer->memory_consumption();
+    return memory;
+  }
+
+private:
+  std::vector<const dealii::DoFHandler<dim>*> dof_handlers;
+  std::vector<dealii::MGConstrainedDoFs> mg_constrained_dofs;
+  AdditionalData additional_data;
+  unsigned int n_levels = 0;
+
+  dealii::MGLevelObject<std::shared_ptr<dealii::MatrixFree<dim, Number>>> level_data;
+  dealii::MGLevelObject<LevelMatrixType> level_matrices;
+  TransferType transfer;
+
+  // the linearization points bound to the level operators by set_nonlinearities() and the
+  // transfers interpolating them, one per nonlinear block
+  dealii::MGLevelObject<VectorType> level_linearization_points;
+  std::vector<std::unique_ptr<dealii::MGTransferMatrixFree<dim, Number>>>
+    interpolation_transfers;
+
+  // the multigrid cycle keeps pointers to the objects above, so it is declared after them
+  dealii::MGLevelObject<typename SmootherType::AdditionalData> smoother_data;
+  dealii::mg::SmootherRelaxation<SmootherType, VectorType> mg_smoother;
+  dealii::MGCoarseGridApplySmoother<VectorType> mg_coarse;
+  dealii::mg::Matrix<VectorType> mg_matrix;
+  dealii::MGLevelObject<dealii::MatrixFreeOperators::MGInterfaceOperator<LevelMatrixType>>
+    interface_matrices;
+  dealii::mg::Matrix<VectorType> mg_interface;
+  std::unique_ptr<dealii::Multigrid<VectorType>> multigrid;
+  std::unique_ptr<dealii::PreconditionMG<dim, VectorType, TransferType>> preconditioner;
+};
+
+#endif // MG_BLOCK_PRECONDITIONER_H
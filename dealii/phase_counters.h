@@ -0,0 +1,208 @@
+#ifndef PHASE_COUNTERS_H
+#define PHASE_COUNTERS_H
+
+#include <deal.II/base/exceptions.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef PHASE_COUNTERS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+/**
+ * The phases of the cell loop of MatrixFreeIntegratorBase. All but the quadrature loop are
+ * done block by block in FEDatas.
+ */
+enum class Phase : unsigned int
+{
+  read_dof_values,
+  evaluate,
+  quadrature,
+  integrate,
+  distribute_local_to_global,
+  n_phases
+};
+
+/**
+ * Cycles spent in each Phase of the cell loop, per FEDatas block. The quadrature loop
+ * evaluates the forms for all blocks at once and is only counted as a whole.
+ */
+class PhaseCounters
+{
+public:
+  static constexpr unsigned int n_phases = static_cast<unsigned int>(Phase::n_phases);
+
+  explicit PhaseCounters(const unsigned int n_blocks = 0)
+    : block_cycles(n_blocks)
+  {
+    reset();
+  }
+
+  void
+  reset()
+  {
+    for (auto& cycles : block_cycles)
+      cycles.fill(0);
+    quadrature_cycles = 0;
+  }
+
+  void
+  add(const unsigned int block, const Phase phase, const std::uint64_t cycles)
+  {
+    if (phase == Phase::quadrature)
+      quadrature_cycles += cycles;
+    else
+    {
+      AssertIndexRange(block, block_cycles.size());
+      block_cycles[block][static_cast<unsigned int>(phase)] += cycles;
+    }
+  }
+
+  PhaseCounters&
+  operator+=(const PhaseCounters& other)
+  {
+    if (block_cycles.size() < other.block_cycles.size())
+      block_cycles.resize(other.block_cycles.size(), std::array<std::uint64_t, n_phases>{});
+    for (unsigned int b = 0; b < other.block_cycles.size(); ++b)
+      for (unsigned int p = 0; p < n_phases; ++p)
+        block_cycles[b][p] += other.block_cycles[b][p];
+    quadrature_cycles += other.quadrature_cycles;
+    return *this;
+  }
+
+  unsigned int
+  n_blocks() const
+  {
+    return block_cycles.size();
+  }
+
+  // the cycles spent in @p phase for @p block, not available for Phase::quadrature
+  std::uint64_t
+  get_cycles(const Phase phase, const unsigned int block) const
+  {
+    Assert(phase != Phase::quadrature,
+           dealii::ExcMessage("The quadrature loop is not counted per block!"));
+    AssertIndexRange(block, block_cycles.size());
+    return block_cycles[block][static_cast<unsigned int>(phase)];
+  }
+
+  // the cycles spent in @p phase for all blocks
+  std::uint64_t
+  get_cycles(const Phase phase) const
+  {
+    if (phase == Phase::quadrature)
+      return quadrature_cycles;
+    std::uint64_t cycles = 0;
+    for (unsigned int b = 0; b < block_cycles.size(); ++b)
+      cycles += get_cycles(phase, b);
+    return cycles;
+  }
+
+  std::uint64_t
+  get_total_cycles() const
+  {
+    std::uint64_t cycles = 0;
+    for (unsigned int p = 0; p < n_phases; ++p)
+      cycles += get_cycles(static_cast<Phase>(p));
+    return cycles;
+  }
+
+  static const char*
+  phase_name(const Phase phase)
+  {
+    static const std::array<const char*, n_phases> names = {
+      { "read_dof_values", "evaluate", "quadrature", "integrate", "distribute" }
+    };
+    return names[static_cast<unsigned int>(phase)];
+  }
+
+  /**
+   * Print a table of the cycles per phase and block, with the share of each phase in the
+   * total.
+   */
+  void
+  print(std::ostream& out) const
+  {
+    const double total = std::max<std::uint64_t>(get_total_cycles(), 1);
+    out << std::left << std::setw(18) << "phase" << std::right;
+    for (unsigned int b = 0; b < block_cycles.size(); ++b)
+      out << std::setw(15) << ("block " + std::to_string(b));
+    out << std::setw(15) << "total" << std::setw(8) << "%" << std::endl;
+    for (unsigned int p = 0; p < n_phases; ++p)
+    {
+      const Phase phase = static_cast<Phase>(p);
+      out << std::left << std::setw(18) << phase_name(phase) << std::right;
+      for (unsigned int b = 0; b < block_cycles.size(); ++b)
+        if (phase == Phase::quadrature)
+          out << std::setw(15) << "-";
+        else
+          out << std::setw(15) << get_cycles(phase, b);
+      out << std::setw(15) << get_cycles(phase) << std::setw(8) << std::fixed
+          << std::setprecision(1) << 100. * get_cycles(phase) / total << std::endl;
+    }
+  }
+
+private:
+  std::vector<std::array<std::uint64_t, n_phases>> block_cycles;
+  std::uint64_t quadrature_cycles;
+};
+
+#ifdef PHASE_COUNTERS
+inline std::uint64_t
+read_cycle_counter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/**
+ * Adds the cycles between its construction and destruction to @p counters, if not nullptr.
+ * Without PHASE_COUNTERS it does nothing and is optimized away.
+ */
+class PhaseTimer
+{
+public:
+  PhaseTimer(PhaseCounters* counters_, const unsigned int block_, const Phase phase_)
+    : counters(counters_)
+    , block(block_)
+    , phase(phase_)
+    , start(read_cycle_counter())
+  {
+  }
+
+  ~PhaseTimer()
+  {
+    if (counters != nullptr)
+      counters->add(block, phase, read_cycle_counter() - start);
+  }
+
+private:
+  PhaseCounters* const counters;
+  const unsigned int block;
+  const Phase phase;
+  const std::uint64_t start;
+};
+#else
+class PhaseTimer
+{
+public:
+  PhaseTimer(PhaseCounters* /*counters*/, const unsigned int /*block*/, const Phase /*phase*/)
+  {
+  }
+};
+#endif
+
+#endif // PHASE_COUNTERS_H
@@ -0,0 +1,140 @@
+#ifndef SOLVER_CG_FUSED_H
+#define SOLVER_CG_FUSED_H
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * The conjugate gradient method for MatrixFreeIntegrator operators on non-block vectors, with
+ * all vector operations fused into the cell loop of the operator, see
+ * MatrixFreeIntegratorBase::vmult_fused(). Before a cell batch reads a range of the search
+ * direction p, the updates x += alpha p, r -= alpha Ap and p = P r + beta p of the previous
+ * iteration are applied to it. After the last cell batch has written to a range of Ap, it
+ * contributes to all dot products of the iteration. Each iteration thus sweeps once over the
+ * vectors and needs a single global reduction, compared to several sweeps and two reductions
+ * of dealii::SolverCG.
+ *
+ * Since alpha is only known after the reduction, r^T P r of the next iteration follows from
+ * the recurrence r' = r - alpha Ap, and so does the residual norm passed to the SolverControl.
+ * Both are recomputed from the updated vectors in every iteration. The preconditioner P is
+ * the identity or a DiagonalMatrix, e.g. the inverse diagonal of the operator.
+ */
+template <typename VectorType>
+class SolverCGFused
+{
+public:
+  using Number = typename VectorType::value_type;
+
+  explicit SolverCGFused(dealii::SolverControl& solver_control_)
+    : solver_control(solver_control_)
+  {
+  }
+
+  template <typename OperatorType>
+  void
+  solve(const OperatorType& A, VectorType& x, const VectorType& b,
+        const dealii::PreconditionIdentity& /*preconditioner*/)
+  {
+    solve(A, x, b, nullptr);
+  }
+
+  template <typename OperatorType>
+  void
+  solve(const OperatorType& A, VectorType& x, const VectorType& b,
+        const dealii::DiagonalMatrix<VectorType>& preconditioner)
+  {
+    solve(A, x, b, &preconditioner.get_vector());
+  }
+
+private:
+  dealii::SolverControl& solver_control;
+
+  // the dot products of an iteration, reduced at once
+  enum Product
+  {
+    p_Ap,
+    Ap_Ap,
+    r_Ap,
+    r_r,
+    r_Pr,
+    Ap_Pr,
+    Ap_PAp,
+    n_products
+  };
+
+  template <typename OperatorType>
+  void
+  solve(const OperatorType& A, VectorType& x, const VectorType& b,
+        const VectorType* inverse_diagonal)
+  {
+    VectorType r;
+    VectorType p;
+    VectorType Ap;
+    A.initialize_dof_vector(r);
+    A.initialize_dof_vector(p);
+    A.initialize_dof_vector(Ap);
+    A.vmult(r, x);
+    r.sadd(-1., 1., b);
+    dealii::SolverControl::State state = solver_control.check(0, r.l2_norm());
+
+    const auto diagonal = [&](const unsigned int i) {
+      return inverse_diagonal != nullptr ? inverse_diagonal->local_element(i) : Number(1.);
+    };
+    Number alpha = 0.;
+    Number beta = 0.;
+    std::vector<double> local_products(n_products);
+    std::vector<double> products(n_products);
+    for (unsigned int step = 1; state == dealii::SolverControl::iterate; ++step)
+    {
+      std::fill(local_products.begin(), local_products.end(), 0.);
+      A.vmult(Ap,
+              p,
+              [&](const unsigned int begin, const unsigned int end) {
+                for (unsigned int i = begin; i < end; ++i)
+                {
+                  x.local_element(i) += alpha * p.local_element(i);
+                  r.local_element(i) -= alpha * Ap.local_element(i);
+                  p.local_element(i) = diagonal(i) * r.local_element(i) + beta * p.local_element(i);
+                }
+              },
+              [&](const unsigned int begin, const unsigned int end) {
+                for (unsigned int i = begin; i < end; ++i)
+                {
+                  const Number p_i = p.local_element(i);
+                  const Number r_i = r.local_element(i);
+                  const Number Ap_i = Ap.local_element(i);
+                  const Number d_i = diagonal(i);
+                  local_products[p_Ap] += p_i * Ap_i;
+                  local_products[Ap_Ap] += Ap_i * Ap_i;
+                  local_products[r_Ap] += r_i * Ap_i;
+                  local_products[r_r] += r_i * r_i;
+                  local_products[r_Pr] += r_i * d_i * r_i;
+                  local_products[Ap_Pr] += Ap_i * d_i * r_i;
+                  local_products[Ap_PAp] += Ap_i * d_i * Ap_i;
+                }
+              });
+      dealii::Utilities::MPI::sum(local_products, x.get_mpi_communicator(), products);
+
+      alpha = products[r_Pr] / products[p_Ap];
+      const double residual_squared = std::max(
+        0., products[r_r] - 2. * alpha * products[r_Ap] + alpha * alpha * products[Ap_Ap]);
+      beta = (products[r_Pr] - 2. * alpha * products[Ap_Pr] + alpha * alpha * products[Ap_PAp]) /
+             products[r_Pr];
+      state = solver_control.check(step, std::sqrt(residual_squared));
+    }
+    // the update of x in the last iteration is still pending
+    x.add(alpha, p);
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(solver_control.last_step(),
+                                                     solver_control.last_value()));
+  }
+};
+
+#endif // SOLVER_CG_FUSED_H
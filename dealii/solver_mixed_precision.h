@@ -0,0 +1,93 @@
+#ifndef SOLVER_MIXED_PRECISION_H
+#define SOLVER_MIXED_PRECISION_H
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+/**
+ * Iterative refinement with an inner Krylov solver in lower precision: the residual
+ * r = b - A x is computed with the operator @p A in the precision of VectorType, e.g. double,
+ * rounded to InnerVectorType, e.g. float, and the correction A_inner d = r is solved only
+ * approximately by InnerSolverType (CG by default) with the operator @p A_inner and the
+ * preconditioner in that precision. Then x += d, until the SolverControl given to the
+ * constructor is satisfied by the norm of the residual in full precision.
+ *
+ * For CFL operators, A and A_inner are MatrixFreeIntegrators of the same form with the FEDatas
+ * in double and in float, e.g. those of the system and of the multigrid levels, so the
+ * solution is as accurate as with the double operator alone, while the inner iterations move
+ * half the bytes. Each outer step costs one application of A.
+ */
+template <typename VectorType, typename InnerVectorType,
+          template <typename> class InnerSolverType = dealii::SolverCG>
+class SolverMixedPrecision
+{
+public:
+  struct AdditionalData
+  {
+    // the reduction of the residual by each inner solve and the maximal number of iterations,
+    // an inner solve not reaching the reduction throws SolverControl::NoConvergence
+    double inner_reduction = 1e-3;
+    unsigned int max_inner_iterations = 100;
+  };
+
+  explicit SolverMixedPrecision(dealii::SolverControl& solver_control_,
+                                const AdditionalData& additional_data_ = AdditionalData())
+    : solver_control(solver_control_)
+    , additional_data(additional_data_)
+  {
+  }
+
+  template <typename OperatorType, typename InnerOperatorType, typename PreconditionerType>
+  void
+  solve(const OperatorType& A, const InnerOperatorType& A_inner, VectorType& x,
+        const VectorType& b, const PreconditionerType& preconditioner)
+  {
+    VectorType r(x);
+    InnerVectorType r_inner;
+    InnerVectorType d_inner;
+    A_inner.initialize_dof_vector(r_inner);
+    A_inner.initialize_dof_vector(d_inner);
+    n_inner_iterations = 0;
+
+    dealii::SolverControl::State state = dealii::SolverControl::iterate;
+    for (unsigned int step = 0; state == dealii::SolverControl::iterate; ++step)
+    {
+      A.vmult(r, x);
+      r.sadd(-1., 1., b);
+      state = solver_control.check(step, r.l2_norm());
+      if (state != dealii::SolverControl::iterate)
+        break;
+
+      r_inner = r;
+      d_inner = 0.;
+      dealii::ReductionControl inner_control(
+        additional_data.max_inner_iterations, 0., additional_data.inner_reduction, false, false);
+      InnerSolverType<InnerVectorType> inner_solver(inner_control);
+      // the correction is only needed approximately, the next residual shows its error
+      inner_solver.solve(A_inner, d_inner, r_inner, preconditioner);
+      n_inner_iterations += inner_control.last_step();
+
+      r = d_inner;
+      x += r;
+    }
+
+    AssertThrow(state == dealii::SolverControl::success,
+                dealii::SolverControl::NoConvergence(solver_control.last_step(),
+                                                     solver_control.last_value()));
+  }
+
+  // the iterations of all inner solves of the last call of solve()
+  unsigned int
+  get_n_inner_iterations() const
+  {
+    return n_inner_iterations;
+  }
+
+private:
+  dealii::SolverControl& solver_control;
+  const AdditionalData additional_data;
+  unsigned int n_inner_iterations = 0;
+};
+
+#endif // SOLVER_MIXED_PRECISION_H
@@ -169,13 +169,14 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::setup_system()
   time.restart();
   {
     typename MatrixFree<dim, double>::AdditionalData additional_data;
-    additional_data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim, double>::AdditionalData::partition_partition;
     additional_data.mapping_update_flags =
       (update_gradients | update_JxW_values | update_quadrature_points);
     system_mf_storage.reinit(dof_handler, constraints, QGauss<1>(fe.degree + 1), additional_data);
   }
 
-  system_matrix.initialize(std::make_shared<MatrixFree<dim, double>>(system_mf_storage),
+  system_matrix.initialize(make_matrix_free_handle(system_mf_storage),
                            std::make_shared<Form>(form),
                            std::make_shared<FEDatasSystem>(mf_cfl_data_system));
 
@@ -208,7 +209,8 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::setup_system()
     level_constraints.close();
 
     typename MatrixFree<dim, float>::AdditionalData additional_data;
-    additional_data.tasks_parallel_scheme = MatrixFree<dim, float>::AdditionalData::none;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim, float>::AdditionalData::partition_partition;
     additional_data.mapping_update_flags =
       (update_gradients | update_JxW_values | update_quadrature_points);
     additional_data.level_mg_handler = level;
@@ -216,7 +218,7 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::setup_system()
     mg_mf_storage[level].reinit(
       dof_handler, level_constraints, QGauss<1>(fe.degree + 1), additional_data);
 
-    mg_matrices[level].initialize(std::make_shared<MatrixFree<dim, float>>(mg_mf_storage[level]),
+    mg_matrices[level].initialize(make_matrix_free_handle(mg_mf_storage[level]),
                                   mg_constrained_dofs,
                                   level,
                                   std::make_shared<Form>(form),
@@ -391,7 +393,7 @@ main(int argc, char* argv[])
   {
     using namespace Step37;
 
-    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, numbers::invalid_unsigned_int);
 
     FE_Q<dimension> fe_u(degree_finite_element);
 
@@ -0,0 +1,114 @@
+#ifndef TENSOR_PRODUCT_KERNELS_H
+#define TENSOR_PRODUCT_KERNELS_H
+
+#include <array>
+
+/**
+ * Sum factorization kernels on the reference cell, used to build diagonals and local matrices
+ * from the quadrature point representation of an operator.
+ *
+ * All arrays are stored lexicographically with the first coordinate direction running fastest.
+ * A 1D matrix has n_dofs_1d rows and n_q_points_1d columns, the quadrature index running
+ * fastest, just like the shape_values and shape_gradients arrays of
+ * dealii::internal::MatrixFreeFunctions::ShapeInfo.
+ */
+template <int dim, int n_dofs_1d, int n_q_points_1d, typename Number>
+struct TensorProductKernels
+{
+  static constexpr unsigned int
+  static_pow(const unsigned int base, const unsigned int exponent)
+  {
+    return exponent == 0 ? 1 : base * static_pow(base, exponent - 1);
+  }
+
+  static constexpr unsigned int n_dofs = static_pow(n_dofs_1d, dim);
+  static constexpr unsigned int n_q_points = static_pow(n_q_points_1d, dim);
+  // size of the temporary arrays needed by integrate()
+  static constexpr unsigned int n_scratch =
+    static_pow(n_dofs_1d > n_q_points_1d ? n_dofs_1d : n_q_points_1d, dim);
+
+  /**
+   * Contract the quadrature index in @p direction of @p in with the columns of @p matrix.
+   * Directions before @p direction have been contracted already and run over n_dofs_1d,
+   * the remaining ones run over n_q_points_1d.
+   */
+  template <int direction, bool add>
+  static inline void
+  contract(const Number* matrix, const Number* in, Number* out)
+  {
+    constexpr unsigned int n_before = static_pow(n_dofs_1d, direction);
+    constexpr unsigned int n_after = static_pow(n_q_points_1d, dim - direction - 1);
+    for (unsigned int b = 0; b < n_after; ++b)
+      for (unsigned int i = 0; i < n_dofs_1d; ++i)
+        for (unsigned int a = 0; a < n_before; ++a)
+        {
+          const Number* in_ptr = in + a + n_before * n_q_points_1d * b;
+          Number sum = matrix[i * n_q_points_1d] * in_ptr[0];
+          for (unsigned int q = 1; q < n_q_points_1d; ++q)
+            sum += matrix[i * n_q_points_1d + q] * in_ptr[n_before * q];
+          if (add)
+            out[a + n_before * (i + n_dofs_1d * b)] += sum;
+          else
+            out[a + n_before * (i + n_dofs_1d * b)] = sum;
+        }
+  }
+
+  /**
+   * Add sum_q prod_d matrices[d][i_d][q_d] in[q] to out[i] for all tensor product indices i.
+   * @p tmp0 and @p tmp1 must hold n_scratch entries each.
+   */
+  static inline void
+  integrate(const std::array<const Number*, dim>& matrices, const Number* in, Number* out,
+            Number* tmp0, Number* tmp1)
+  {
+    if constexpr(dim == 1)
+    {
+      (void)tmp0;
+      (void)tmp1;
+      contract<0, true>(matrices[0], in, out);
+    }
+    else if constexpr(dim == 2)
+    {
+      (void)tmp1;
+      contract<0, false>(matrices[0], in, tmp0);
+      contract<1, true>(matrices[1], tmp0, out);
+    }
+    else
+    {
+      static_assert(dim == 3, "Only implemented for dim <= 3!");
+      contract<0, false>(matrices[0], in, tmp0);
+      contract<1, false>(matrices[1], tmp0, tmp1);
+      contract<2, true>(matrices[2], tmp1, out);
+    }
+  }
+
+  /**
+   * Evaluate the tensor product function prod_d matrices[d][j_d][q_d] belonging to the
+   * lexicographic index @p j in all quadrature points.
+   */
+  static inline void
+  evaluate_basis_function(const std::array<const Number*, dim>& matrices, const unsigned int j,
+                          Number* out)
+  {
+    std::array<unsigned int, dim> j_1d;
+    unsigned int rest = j;
+    for (unsigned int d = 0; d < dim; ++d)
+    {
+      j_1d[d] = rest % n_dofs_1d;
+      rest /= n_dofs_1d;
+    }
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      unsigned int q_rest = q;
+      Number value = matrices[0][j_1d[0] * n_q_points_1d + q_rest % n_q_points_1d];
+      for (unsigned int d = 1; d < dim; ++d)
+      {
+        q_rest /= n_q_points_1d;
+        value *= matrices[d][j_1d[d] * n_q_points_1d + q_rest % n_q_points_1d];
+      }
+      out[q] = value;
+    }
+  }
+};
+
+#endif // TENSOR_PRODUCT_KERNELS_H
@@ -0,0 +1,135 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// The SparseMatrix assembled from the forms by assemble_matrix() compared column by column with
+// the operator applied to the unit vectors, for a scalar Laplace plus mass operator and for a
+// vector valued operator whose grad div term couples the components.
+
+#include "test_integrator.h"
+
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim, class FE, class FEDatasType, class FormType>
+void
+check(const std::string& name, const FE& fe, const FEDatasType& fe_datas, const FormType& forms,
+      const unsigned int refine)
+{
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit();
+  MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType> op;
+  op.initialize(fixture.data, forms, fe_datas);
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(fixture.dof.n_dofs(), fixture.dof.n_dofs());
+    DoFTools::make_sparsity_pattern(fixture.dof, dsp, fixture.constraints, false);
+    sparsity.copy_from(dsp);
+  }
+  SparseMatrix<double> matrix(sparsity);
+  op.assemble_matrix(matrix, fixture.constraints);
+
+  VectorType unit_vector = fixture.vector();
+  VectorType column = fixture.vector();
+  double max_error = 0.;
+  double max_entry = 0.;
+  for (types::global_dof_index j = 0; j < unit_vector.size(); ++j)
+  {
+    unit_vector = 0.;
+    unit_vector(j) = 1.;
+    op.vmult(column, unit_vector);
+    for (types::global_dof_index i = 0; i < column.size(); ++i)
+    {
+      max_error = std::max(max_error, std::abs(matrix.el(i, j) - column(i)));
+      max_entry = std::max(max_entry, std::abs(column(i)));
+    }
+  }
+  AssertThrow(max_error < 1.e-12 * max_entry,
+              ExcMessage(name + ": error " + std::to_string(max_error / max_entry)));
+
+  const VectorType u_h = fixture.sum_of_coordinates();
+  Vector<double> u(u_h.size());
+  for (types::global_dof_index i = 0; i < u.size(); ++i)
+    u(i) = u_h(i);
+  print_value(name + ", SparseMatrix", "(u, A u)", matrix.matrix_scalar_product(u, u));
+  print_value(name + ", vmult", "(u, A u)", energy(op, u_h));
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  {
+    FE_Q<dim> fe(degree);
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+    TestFunction<0, dim, 0> v;
+    FEFunction<0, dim, 0> u("u");
+    check<dim>(
+      prefix + "Laplace + mass", fe, fe_datas, form(grad(u), grad(v)) + form(u, v), refine);
+  }
+  {
+    FESystem<dim> fe(FE_Q<dim>(degree), dim);
+    FEData<FESystem, degree, dim, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+    TestFunction<1, dim, 0> v;
+    FEFunction<1, dim, 0> u("u");
+    check<dim>(prefix + "vector Laplace + grad div",
+               fe,
+               fe_datas,
+               form(grad(u), grad(v)) + form(div(u), div(v)),
+               refine);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(2);
+    run<3>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// vmult of forms with the product u*u and grad(u) in several forms, once with the forms as
+// they are and once through eliminate_common_subexpressions(), which evaluates them only once
+// per quadrature point. Both operators give the same result.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/dealii_matrixfree_cse.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim, class FormsType, class FEDatas>
+BlockVectorType
+apply(const IntegratorFixture<dim>& fixture, const FormsType& forms, const FEDatas& fe_datas,
+      const BlockVectorType& src)
+{
+  MatrixFreeIntegrator<dim, BlockVectorType, FormsType, FEDatas> op;
+  op.initialize(fixture.data, forms, fe_datas);
+  BlockVectorType dst(src);
+  op.vmult(dst, src);
+  return dst;
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_e(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_u(fe);
+  auto fe_datas = (fedata_e, fedata_u);
+
+  TestFunction<0, dim, 0> v;
+  TestFunction<0, dim, 1> w;
+  FEFunction<0, dim, 0> e("e");
+  FEFunction<0, dim, 1> u("u");
+  const auto forms = form(u * u * e, v) + form(u * u, v) + form(grad(u), grad(v)) +
+                     form(3. * u * u * e - u, w) + form(grad(u), grad(w));
+  const auto cse_forms = eliminate_common_subexpressions(forms);
+  // without elimination, u*u*e is evaluated twice, u*u three times, u seven times and e and
+  // grad(u) twice each, with elimination each of these five only once
+  static_assert(decltype(cse_forms)::n_evaluations == 16, "");
+  static_assert(decltype(cse_forms)::n_removed_evaluations == 11, "");
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit_blocks(2);
+  // e = u = x + y (+ z)
+  const BlockVectorType src = fixture.block_sum_of_coordinates(2);
+  const BlockVectorType result = apply(fixture, forms, fe_datas, src);
+  const BlockVectorType cse_result = apply(fixture, cse_forms, fe_datas, src);
+
+  // (e, A_0 u) = (u u e + u u, e) + (grad u, grad e) is 167/30 in 2D and 161/10 in 3D,
+  // (u, A_1 u) = (3 u u e - u, u) + (grad u, grad u) is 211/30 and 263/10
+  const std::string name = "dim " + std::to_string(dim);
+  check_equal(name, cse_result, result);
+  print_value(name, "(e, A_0 u)", cse_result.block(0) * src.block(0));
+  print_value(name, "(u, A_1 u)", cse_result.block(1) * src.block(1));
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv);
+  try
+  {
+    run<2>(3);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
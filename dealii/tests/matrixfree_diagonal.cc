@@ -0,0 +1,117 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// The diagonal computed by sum factorization, compute_diagonal(), compared with the diagonal
+// entries of the operator applied to every unit vector, for a scalar Laplace plus mass
+// operator and for a vector valued operator whose grad div term couples the components. The
+// trace of the diagonal is n_cells times that of the cell matrices, e.g. 16 (2 tr(K) tr(M) +
+// h^2 tr(M)^2) = 256.64 for the scalar operator in 2D with the 1D matrices K and M of Q_2.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim, class FE, class FEDatasType, class FormType>
+void
+check(const std::string& name, const FE& fe, const FEDatasType& fe_datas, const FormType& forms,
+      const unsigned int refine)
+{
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit();
+  MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType> op;
+  op.initialize(fixture.data, forms, fe_datas);
+  op.compute_diagonal();
+  const VectorType& inverse_diagonal = op.get_matrix_diagonal_inverse()->get_vector();
+
+  VectorType unit_vector = fixture.vector();
+  VectorType column = fixture.vector();
+  VectorType diagonal = fixture.vector();
+  VectorType reference = fixture.vector();
+  for (types::global_dof_index j = 0; j < unit_vector.size(); ++j)
+  {
+    unit_vector = 0.;
+    unit_vector(j) = 1.;
+    op.vmult(column, unit_vector);
+    reference(j) = column(j);
+    diagonal(j) = 1. / inverse_diagonal(j);
+  }
+  check_equal(name, diagonal, reference);
+  // the diagonal is positive, so its l1 norm is the trace
+  print_value(name, "trace", diagonal.l1_norm());
+  print_value(name, "(u, A u)", energy(op, fixture.sum_of_coordinates()));
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  {
+    FE_Q<dim> fe(degree);
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+    TestFunction<0, dim, 0> v;
+    FEFunction<0, dim, 0> u("u");
+    check<dim>(
+      prefix + "Laplace + mass", fe, fe_datas, form(grad(u), grad(v)) + form(u, v), refine);
+  }
+  {
+    FESystem<dim> fe(FE_Q<dim>(degree), dim);
+    FEData<FESystem, degree, dim, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+    TestFunction<1, dim, 0> v;
+    FEFunction<1, dim, 0> u("u");
+    check<dim>(prefix + "vector Laplace + grad div",
+               fe,
+               fe_datas,
+               form(grad(u), grad(v)) + form(div(u), div(v)),
+               refine);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(2);
+    run<3>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
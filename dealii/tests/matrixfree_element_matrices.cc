@@ -0,0 +1,118 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// vmult with precomputed element matrices, ExecutionMode::element_matrices, and with the faster
+// variant chosen by ExecutionMode::automatic compared with the matrix-free vmult, for a scalar
+// Laplace plus mass operator and for a vector valued operator coupling the components.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim, class FE, class FEDatasType, class FormType>
+void
+check(const std::string& name, const FE& fe, const FEDatasType& fe_datas, const FormType& forms,
+      const unsigned int refine)
+{
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit();
+  MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType> op;
+  op.initialize(fixture.data, forms, fe_datas);
+
+  const VectorType u_h = fixture.sum_of_coordinates();
+  VectorType reference = fixture.vector();
+  VectorType result = fixture.vector();
+  op.vmult(reference, u_h);
+  AssertThrow(!op.uses_element_matrices(), ExcInternalError());
+  print_value(name + ", matrix_free", "(u, A u)", reference * u_h);
+
+  op.set_execution_mode(ExecutionMode::element_matrices);
+  AssertThrow(op.uses_element_matrices(), ExcInternalError());
+  op.vmult(result, u_h);
+  check_equal(name + ", element_matrices", result, reference);
+  print_value(name + ", element_matrices", "(u, A u)", result * u_h);
+
+  // whichever variant is selected, the result is the same
+  op.set_execution_mode(ExecutionMode::automatic);
+  op.vmult(result, u_h);
+  check_equal(name + ", automatic", result, reference);
+  print_value(name + ", automatic", "(u, A u)", result * u_h);
+
+  op.set_execution_mode(ExecutionMode::matrix_free);
+  AssertThrow(!op.uses_element_matrices(), ExcInternalError());
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  {
+    FE_Q<dim> fe(degree);
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+    TestFunction<0, dim, 0> v;
+    FEFunction<0, dim, 0> u("u");
+    check<dim>(
+      prefix + "Laplace + mass", fe, fe_datas, form(grad(u), grad(v)) + form(u, v), refine);
+  }
+  {
+    FESystem<dim> fe(FE_Q<dim>(degree), dim);
+    FEData<FESystem, degree, dim, dim, 0, degree> fedata(fe);
+    FEDatas<decltype(fedata)> fe_datas{ fedata };
+    TestFunction<1, dim, 0> v;
+    FEFunction<1, dim, 0> u("u");
+    check<dim>(prefix + "vector Laplace + grad div",
+               fe,
+               fe_datas,
+               form(grad(u), grad(v)) + form(div(u), div(v)),
+               refine);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(2);
+    run<3>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// Face and boundary loops: applying the sum of a jump, an average and a boundary form gives the
+// sum of applying each of them. Jumps and averages both submit values on interior faces, so this
+// checks that forms tested by different test functions submitting to the same data add up.
+
+#include <deal.II/fe/fe_dgq.h>
+#include <dealii/matrixfree_data.h>
+
+#include <deal.II/base/multithread_info.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim, class FEDatasType, class FormsType>
+Vector<double>
+apply(FiniteElement<dim>& fe, const FEDatasType& fe_datas, const FormsType& forms,
+      unsigned int refine)
+{
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+
+  MatrixFreeData<dim, FEDatasType, FormsType, LinearAlgebra::distributed::BlockVector<double>>
+    data{ 0, refine, fes, fe_datas, forms };
+
+  LinearAlgebra::distributed::BlockVector<double> src(1), dst(1);
+  data.resize_vector(src);
+  data.resize_vector(dst);
+  for (types::global_dof_index j = 0; j < src.block(0).size(); ++j)
+    src.block(0)[j] = 1. + (j % 7) * 0.25;
+
+  data.vmult(dst, src);
+
+  Vector<double> result(dst.block(0).size());
+  for (types::global_dof_index j = 0; j < result.size(); ++j)
+    result[j] = dst.block(0)[j];
+  return result;
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 1;
+  FE_DGQ<dim> fe(degree);
+
+  FEData<FE_DGQ, degree, 1, dim, 0, degree> fedata{ fe };
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  TestFunction<0, dim, 0> v;
+  FEFunction<0, dim, 0> u("u");
+  const auto jump_form = form(jump(u), jump(v));
+  const auto average_form = form(average(u), average(v));
+  const auto boundary_form = form(boundary_value(u), boundary_value(v));
+  const auto forms = jump_form + average_form + boundary_form;
+
+  Vector<double> separate = apply<dim>(fe, fe_datas, jump_form, refine);
+  separate += apply<dim>(fe, fe_datas, average_form, refine);
+  separate += apply<dim>(fe, fe_datas, boundary_form, refine);
+  Vector<double> combined = apply<dim>(fe, fe_datas, forms, refine);
+
+  AssertThrow(combined.l2_norm() > 0., ExcInternalError());
+  combined -= separate;
+  const double relative_error = combined.l2_norm() / separate.l2_norm();
+  AssertThrow(relative_error < 1.e-12,
+              ExcMessage("relative error " + std::to_string(relative_error)));
+  std::cout << "dim " << dim << ": jump + average + boundary_value OK" << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
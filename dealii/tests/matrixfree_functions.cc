@@ -0,0 +1,178 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// The vectorized functions of FEUnaryFunction compared with the std:: functions for every
+// accuracy level, on a regular sampling and at the edges of their range reductions: exp and
+// log near over- and underflow, at zero, negative and subnormal numbers and infinity, sin and
+// cos near multiples of pi/4 and tanh where it saturates.
+
+#include <cfl/dealii_matrixfree_functions.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace CFL::dealii::MatrixFree;
+
+// the largest error relative to |std::f(x)|, or to 1 where |std::f(x)| < 1
+template <typename Number, class Function, class Reference>
+double
+max_error(const std::vector<double>& points, const Function& function,
+          const Reference& reference)
+{
+  double error = 0.;
+  for (const double x : points)
+  {
+    const VectorizedArray<Number> value = function(make_vectorized_array(static_cast<Number>(x)));
+    const double exact = reference(static_cast<Number>(x));
+    for (unsigned int l = 0; l < VectorizedArray<Number>::n_array_elements; ++l)
+      error = std::max(error, std::abs(value[l] - exact) / std::max(std::abs(exact), 1.));
+  }
+  return error;
+}
+
+std::vector<double>
+sample(const double begin, const double end, const unsigned int n)
+{
+  std::vector<double> points;
+  for (unsigned int i = 0; i <= n; ++i)
+    points.push_back(begin + (end - begin) * i / n);
+  return points;
+}
+
+template <Accuracy accuracy>
+void
+check_accuracy(const std::string& name, const double tolerance)
+{
+  std::vector<double> exp_points = sample(-700., 700., 10000);
+  for (const double x : { -745., -740., -709., -708., 708., 709., 709.7, 1.e-20, -1.e-20 })
+    exp_points.push_back(x);
+  const double exp_error = max_error<double>(
+    exp_points, [](const auto& x) { return simd::exp<accuracy>(x); },
+    [](const double x) { return std::exp(x); });
+  AssertThrow(exp_error < tolerance, ExcMessage("exp error " + std::to_string(exp_error)));
+
+  std::vector<double> log_points = sample(0.01, 100., 10000);
+  for (const double x : { 1., 1. - 1.e-12, 1. + 1.e-12, 1.41421356237309504880,
+                          0.70710678118654752440, 1.e-300, 1.e300, 4.9e-324, 1.e-310 })
+    log_points.push_back(x);
+  const double log_error = max_error<double>(
+    log_points, [](const auto& x) { return simd::log<accuracy>(x); },
+    [](const double x) { return std::log(x); });
+  AssertThrow(log_error < tolerance, ExcMessage("log error " + std::to_string(log_error)));
+
+  std::vector<double> trigonometric_points = sample(-100., 100., 10000);
+  for (int k = -16; k <= 16; ++k)
+    for (const double shift : { -1.e-12, 0., 1.e-12 })
+      trigonometric_points.push_back(k * 0.78539816339744830962 + shift);
+  const double sin_error = max_error<double>(
+    trigonometric_points, [](const auto& x) { return simd::sin<accuracy>(x); },
+    [](const double x) { return std::sin(x); });
+  AssertThrow(sin_error < tolerance, ExcMessage("sin error " + std::to_string(sin_error)));
+  const double cos_error = max_error<double>(
+    trigonometric_points, [](const auto& x) { return simd::cos<accuracy>(x); },
+    [](const double x) { return std::cos(x); });
+  AssertThrow(cos_error < tolerance, ExcMessage("cos error " + std::to_string(cos_error)));
+
+  std::vector<double> tanh_points = sample(-25., 25., 10000);
+  for (const double x : { -20., 20., -1.e-10, 1.e-10, 1000. })
+    tanh_points.push_back(x);
+  const double tanh_error = max_error<double>(
+    tanh_points, [](const auto& x) { return simd::tanh<accuracy>(x); },
+    [](const double x) { return std::tanh(x); });
+  AssertThrow(tanh_error < tolerance, ExcMessage("tanh error " + std::to_string(tanh_error)));
+
+  std::cout << name << ": exp log sin cos tanh OK" << std::endl;
+}
+
+// results that must match std:: exactly: infinities, zeros and NaN
+template <typename Number>
+void
+check_special_values(const std::string& name)
+{
+  const Number infinity = std::numeric_limits<Number>::infinity();
+  const Number nan = std::numeric_limits<Number>::quiet_NaN();
+  const auto exp = [](const Number x) {
+    return simd::exp<Accuracy::high>(make_vectorized_array(x))[0];
+  };
+  const auto log = [](const Number x) {
+    return simd::log<Accuracy::high>(make_vectorized_array(x))[0];
+  };
+
+  AssertThrow(exp(Number(1000.)) == infinity, ExcInternalError());
+  AssertThrow(exp(infinity) == infinity, ExcInternalError());
+  AssertThrow(exp(Number(-1000.)) == Number(0.), ExcInternalError());
+  AssertThrow(exp(-infinity) == Number(0.), ExcInternalError());
+  AssertThrow(std::isnan(exp(nan)), ExcInternalError());
+  AssertThrow(log(Number(0.)) == -infinity, ExcInternalError());
+  AssertThrow(log(Number(-0.)) == -infinity, ExcInternalError());
+  AssertThrow(std::isnan(log(Number(-1.))), ExcInternalError());
+  AssertThrow(std::isnan(log(-infinity)), ExcInternalError());
+  AssertThrow(std::isnan(log(nan)), ExcInternalError());
+  AssertThrow(log(infinity) == infinity, ExcInternalError());
+  AssertThrow(log(Number(1.)) == Number(0.), ExcInternalError());
+
+  // the smallest subnormal number and its logarithm
+  const Number denorm_min = std::numeric_limits<Number>::denorm_min();
+  const double log_error =
+    std::abs(log(denorm_min) - std::log(denorm_min)) / std::abs(std::log(denorm_min));
+  AssertThrow(log_error < 10. * std::numeric_limits<Number>::epsilon(),
+              ExcMessage("log error " + std::to_string(log_error)));
+
+  std::cout << name << ": special values OK" << std::endl;
+}
+
+void
+check_float()
+{
+  const auto exp_error = max_error<float>(
+    sample(-87., 88., 10000), [](const auto& x) { return simd::exp<Accuracy::low>(x); },
+    [](const float x) { return std::exp(x); });
+  AssertThrow(exp_error < 1.e-6, ExcMessage("exp error " + std::to_string(exp_error)));
+  const auto log_error = max_error<float>(
+    sample(1.e-3, 1.e3, 10000), [](const auto& x) { return simd::log<Accuracy::low>(x); },
+    [](const float x) { return std::log(x); });
+  AssertThrow(log_error < 1.e-6, ExcMessage("log error " + std::to_string(log_error)));
+  std::cout << "float low: exp log OK" << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  try
+  {
+    check_accuracy<Accuracy::low>("low", 1.e-6);
+    check_accuracy<Accuracy::medium>("medium", 1.e-10);
+    check_accuracy<Accuracy::high>("high", 1.e-15);
+    check_special_values<double>("double");
+    check_special_values<float>("float");
+    check_float();
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
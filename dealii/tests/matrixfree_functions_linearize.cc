@@ -0,0 +1,144 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// The linearizations of exp, log, sin, cos, sqrt and tanh of an FEFunction at a quadrature
+// point, i.e. the derivatives given by outer_derivative() applied to the increment e, compared
+// with their closed forms and with central differences of the function values. A stand-in for
+// FEEvaluation provides u, shifted for the differences, and e.
+
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/dealii_matrixfree_functions.h>
+#include <cfl/dealii_matrixfree_linearize.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// the values of u (index 0), positive for log and sqrt, and e (index 1) on the lanes of a
+// VectorizedArray, with u shifted by @p shift
+struct Values
+{
+  template <unsigned int idx>
+  VectorizedArray<double>
+  get_value(unsigned int /*q*/) const
+  {
+    VectorizedArray<double> value;
+    for (unsigned int l = 0; l < VectorizedArray<double>::n_array_elements; ++l)
+      value[l] = idx == 0 ? u(l) + shift : e(l);
+    return value;
+  }
+
+  static double
+  u(const unsigned int lane)
+  {
+    return 0.3 + 0.7 * lane;
+  }
+
+  static double
+  e(const unsigned int lane)
+  {
+    return 0.5 + lane;
+  }
+
+  double shift = 0.;
+};
+
+// @p linearization of @p f compared with @p derivative(u) e and the central difference of f
+template <class FormType, class Linearization, class Derivative>
+void
+check(const std::string& name, const FormType& f, const Linearization& linearization,
+      const Derivative& derivative)
+{
+  constexpr double h = 1.e-5;
+  const Values values;
+  const VectorizedArray<double> value = linearization.expr.value(values, 0);
+  const VectorizedArray<double> value_plus = f.expr.value(Values{ h }, 0);
+  const VectorizedArray<double> value_minus = f.expr.value(Values{ -h }, 0);
+  for (unsigned int l = 0; l < VectorizedArray<double>::n_array_elements; ++l)
+  {
+    const double exact = derivative(Values::u(l)) * Values::e(l);
+    const double error = std::abs(value[l] - exact) / std::max(std::abs(exact), 1.);
+    AssertThrow(error < 1.e-14, ExcMessage(name + " error " + std::to_string(error)));
+    const double difference = (value_plus[l] - value_minus[l]) / (2. * h) * Values::e(l);
+    const double difference_error =
+      std::abs(value[l] - difference) / std::max(std::abs(exact), 1.);
+    AssertThrow(difference_error < 1.e-8,
+                ExcMessage(name + " difference error " + std::to_string(difference_error)));
+  }
+  std::cout << name << " OK" << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  try
+  {
+    FEFunction<0, 2, 0> u("u");
+    TestFunction<0, 2, 0> v;
+
+    const auto f_exp = form(exp(u), v);
+    check("linearize exp(u)", f_exp, linearize<0, 1>(f_exp), [](double x) {
+      return std::exp(x);
+    });
+    const auto f_log = form(log(u), v);
+    check("linearize log(u)", f_log, linearize<0, 1>(f_log), [](double x) { return 1. / x; });
+    const auto f_sin = form(sin(u), v);
+    check("linearize sin(u)", f_sin, linearize<0, 1>(f_sin), [](double x) {
+      return std::cos(x);
+    });
+    const auto f_cos = form(cos(u), v);
+    check("linearize cos(u)", f_cos, linearize<0, 1>(f_cos), [](double x) {
+      return -std::sin(x);
+    });
+    const auto f_sqrt = form(sqrt(u), v);
+    check("linearize sqrt(u)", f_sqrt, linearize<0, 1>(f_sqrt), [](double x) {
+      return 0.5 / std::sqrt(x);
+    });
+    const auto f_tanh = form(tanh(u), v);
+    check("linearize tanh(u)", f_tanh, linearize<0, 1>(f_tanh), [](double x) {
+      return 1. - std::tanh(x) * std::tanh(x);
+    });
+
+    // scalar factors of the argument and of the function value
+    const auto f_exp_2u = form(exp(2. * u), v);
+    check("linearize exp(2 u)", f_exp_2u, linearize<0, 1>(f_exp_2u), [](double x) {
+      return 2. * std::exp(2. * x);
+    });
+    const auto f_cos_3 = form(3. * cos(u), v);
+    check("linearize 3 cos(u)", f_cos_3, linearize<0, 1>(f_cos_3), [](double x) {
+      return -3. * std::sin(x);
+    });
+    const auto f_sqrt_2u = form(-sqrt(2. * u), v);
+    check("linearize -sqrt(2 u)", f_sqrt_2u, linearize<0, 1>(f_sqrt_2u), [](double x) {
+      return -1. / std::sqrt(2. * x);
+    });
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
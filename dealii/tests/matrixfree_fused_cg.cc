@@ -0,0 +1,120 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// SolverCGFused, with the vector operations fused into the cell loop, compared with SolverCG on
+// a Laplace operator with hanging nodes and Dirichlet boundary conditions, without and with the
+// inverse diagonal as preconditioner. The right hand side is that of a bubble function in Q_2,
+// so both solvers have to recover its interpolation.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+#include <dealii/solver_cg_fused.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <class Operator, class Preconditioner>
+void
+check(const std::string& name, const Operator& op, const VectorType& rhs,
+      const VectorType& exact, const Preconditioner& preconditioner)
+{
+  VectorType reference, solution;
+  op.initialize_dof_vector(reference);
+  op.initialize_dof_vector(solution);
+
+  SolverControl control(1000, 1.e-12 * rhs.l2_norm());
+  SolverCG<VectorType> solver(control);
+  solver.solve(op, reference, rhs, preconditioner);
+  check_equal(name + ", SolverCG", reference, exact, 1.e-8);
+
+  SolverControl control_fused(1000, 1.e-12 * rhs.l2_norm());
+  SolverCGFused<VectorType> solver_fused(control_fused);
+  solver_fused.solve(op, solution, rhs, preconditioner);
+  check_equal(name + ", SolverCGFused", solution, reference, 1.e-9);
+
+  // the rhs is zero on constrained DoFs, so this is a(u, u) for the bubble function u
+  print_value(name + ", SolverCG", "(x, b)", reference * rhs);
+  print_value(name + ", SolverCGFused", "(x, b)", solution * rhs);
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  TestFunction<0, dim, 0> v;
+  FEFunction<0, dim, 0> u("u");
+  const auto f = form(grad(u), grad(v));
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.refine_first_cell();
+  fixture.make_zero_dirichlet_constraints();
+  fixture.reinit();
+
+  MatrixFreeIntegrator<dim, VectorType, decltype(f), decltype(fe_datas)> op;
+  op.initialize(fixture.data, f, fe_datas);
+  op.compute_diagonal();
+
+  // the right hand side of the interpolated bubble function, which the solvers recover
+  VectorType exact = fixture.vector();
+  VectorTools::interpolate(fixture.dof, Bubble<dim>(), exact);
+  fixture.constraints.set_zero(exact);
+  VectorType rhs = fixture.vector();
+  op.vmult(rhs, exact);
+  fixture.constraints.set_zero(rhs);
+
+  // a(u, u) is 1/45 in 2D and 1/900 in 3D
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  check(prefix + "identity", op, rhs, exact, PreconditionIdentity());
+  check(prefix + "inverse diagonal", op, rhs, exact, *op.get_matrix_diagonal_inverse());
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(0);
+  try
+  {
+    run<2>(3);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// vmult of a Jacobian with the linearization cache enabled compared with vmult of the same
+// Jacobian evaluating the bound linearization point in every application. The point is then
+// changed and bound again: the stale cache is dropped by binding, and
+// update_linearization_cache() stores the data of the changed point.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// the operators with and without the cache give the same block 0
+template <class Operator>
+void
+check(const std::string& name, const Operator& cached_op, const Operator& op,
+      const BlockVectorType& src)
+{
+  BlockVectorType result(src);
+  cached_op.vmult(result, src);
+  BlockVectorType reference(src);
+  op.vmult(reference, src);
+  check_equal(name, result.block(0), reference.block(0));
+  print_value(name, "(e, J e)", result.block(0) * src.block(0));
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_e(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_u(fe);
+  auto fe_datas = (fedata_e, fedata_u);
+
+  TestFunction<0, dim, 0> v;
+  FEFunction<0, dim, 0> e("e");
+  FEFunction<0, dim, 1> u("u");
+  const auto jacobian = form(grad(e), grad(v)) + form(3. * u * u * e, v);
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit_blocks(2);
+  // the increment e and the linearization point u are both x + y (+ z)
+  const BlockVectorType src = fixture.block_sum_of_coordinates(2);
+  VectorType linearization_point = src.block(1);
+
+  using Operator = MatrixFreeIntegrator<dim, BlockVectorType, decltype(jacobian),
+                                        decltype(fe_datas)>;
+  Operator op;
+  op.initialize(fixture.data, jacobian, fe_datas);
+  op.bind_fe_function(1, linearization_point);
+  Operator cached_op;
+  cached_op.initialize(fixture.data, jacobian, fe_datas);
+  cached_op.bind_fe_function(1, linearization_point);
+  cached_op.enable_linearization_cache();
+
+  // (grad e, grad e) + (3 u u e, e) is 41/5 in 2D and 144/5 in 3D
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  check(prefix + "cached", cached_op, op, src);
+
+  // 134/5 in 2D and 531/5 in 3D for u = 2 (x + y (+ z)), after binding and after updating
+  // the cache
+  linearization_point *= 2.;
+  op.bind_fe_function(1, linearization_point);
+  cached_op.bind_fe_function(1, linearization_point);
+  check(prefix + "rebound", cached_op, op, src);
+  cached_op.update_linearization_cache();
+  check(prefix + "rebound and updated", cached_op, op, src);
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(3);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// vmult of the forms generated by linearize compared with the hand-written Jacobians: the
+// Schloegl residual, whose linearization has a negated form, a sum and the merged factors of
+// u*u*u, and a residual with a negated sum of a terminal and a scaled product.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/dealii_matrixfree_linearize.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// the Jacobian generated by linearize and the hand-written one give the same block 0
+template <int dim, class Linearization, class Jacobian, class FEDatas>
+void
+check(const std::string& name, const IntegratorFixture<dim>& fixture,
+      const Linearization& linearization, const Jacobian& jacobian, const FEDatas& fe_datas,
+      const BlockVectorType& src)
+{
+  MatrixFreeIntegrator<dim, BlockVectorType, Linearization, FEDatas> linearized_op;
+  linearized_op.initialize(fixture.data, linearization, fe_datas);
+  MatrixFreeIntegrator<dim, BlockVectorType, Jacobian, FEDatas> op;
+  op.initialize(fixture.data, jacobian, fe_datas);
+
+  BlockVectorType result(src);
+  linearized_op.vmult(result, src);
+  BlockVectorType reference(src);
+  op.vmult(reference, src);
+  check_equal(name, result.block(0), reference.block(0));
+  print_value(name, "(e, J e)", result.block(0) * src.block(0));
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_e(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_u(fe);
+  auto fe_datas = (fedata_e, fedata_u);
+
+  TestFunction<0, dim, 0> v;
+  FEFunction<0, dim, 0> e("e");
+  FEFunction<0, dim, 1> u("u");
+  const double alpha = 10.;
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit_blocks(2);
+  // the increment e and the linearization point u are both x + y (+ z)
+  const BlockVectorType src = fixture.block_sum_of_coordinates(2);
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+
+  // (grad e, grad e) + (3 u u e - alpha e, e) is -52/15 in 2D and 19/5 in 3D
+  const auto rhs = form(-grad(u), grad(v)) + form(-u * u * u + alpha * u, v);
+  const auto jacobian = form(grad(e), grad(v)) + form(3. * u * u * e - alpha * e, v);
+  check(prefix + "schloegl", fixture, linearize<1, 0>(-rhs), jacobian, fe_datas, src);
+
+  // (grad e, grad e) + (6 u u e - e, e) is 397/30 in 2D and 521/10 in 3D
+  const auto residual = form(grad(u), grad(v)) + form(-(u - 2. * u * u * u), v);
+  const auto residual_jacobian = form(grad(e), grad(v)) + form(6. * u * u * e - e, v);
+  check(prefix + "negated sum", fixture, linearize<1, 0>(residual), residual_jacobian, fe_datas,
+        src);
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv);
+  try
+  {
+    run<2>(3);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// SolverMixedPrecision for the coupled Laplace blocks of matrixfree_multigrid, with the inner
+// CG and MGBlockPreconditioner in float: the double residual reaches a tolerance far below the
+// accuracy of float, and the solution is the interpolated bubble function. An inner solve that
+// cannot reach its reduction throws instead of being ignored.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+#include <dealii/mg_block_preconditioner.h>
+#include <dealii/solver_mixed_precision.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+using BlockVectorTypeFloat = LinearAlgebra::distributed::BlockVector<float>;
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_0(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_1(fe);
+  auto fe_datas = (fedata_0, fedata_1);
+  FEData<FE_Q, degree, 1, dim, 0, degree, float> fedata_0_float(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree, float> fedata_1_float(fe);
+  auto fe_datas_float = (fedata_0_float, fedata_1_float);
+
+  TestFunction<0, dim, 0> v_0;
+  TestFunction<0, dim, 1> v_1;
+  FEFunction<0, dim, 0> u_0("u_0");
+  FEFunction<0, dim, 1> u_1("u_1");
+  const auto forms = form(grad(u_0), grad(v_0)) + form(u_1, v_0) + form(grad(u_1), grad(v_1)) +
+                     form(u_0, v_1);
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.make_zero_dirichlet_constraints();
+  fixture.reinit_blocks(2);
+  MatrixFree<dim, float> data_float;
+  fixture.reinit_blocks(2, data_float);
+  fixture.distribute_mg_dofs(true);
+
+  MatrixFreeIntegrator<dim, BlockVectorType, decltype(forms), decltype(fe_datas)> op;
+  op.initialize(fixture.data, forms, fe_datas);
+  MatrixFreeIntegrator<dim, BlockVectorTypeFloat, decltype(forms), decltype(fe_datas_float)>
+    op_float;
+  op_float.initialize(data_float, forms, fe_datas_float);
+  MGBlockPreconditioner<dim, decltype(forms), decltype(fe_datas_float)> preconditioner;
+  preconditioner.initialize({ &fixture.dof, &fixture.dof },
+                            { fixture.mg_constrained_dofs, fixture.mg_constrained_dofs },
+                            forms,
+                            fe_datas_float);
+  preconditioner.update_smoothers();
+
+  const BlockVectorType exact = fixture.block_vector(2, Bubble<dim>());
+  BlockVectorType rhs(exact);
+  op.vmult(rhs, exact);
+  BlockVectorType solution(exact);
+  solution = 0.;
+
+  const double tolerance = 1.e-12 * rhs.l2_norm();
+  SolverControl control(100, tolerance);
+  SolverMixedPrecision<BlockVectorType, BlockVectorTypeFloat> solver(control);
+  solver.solve(op, op_float, solution, rhs, preconditioner);
+
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  BlockVectorType residual(rhs);
+  op.vmult(residual, solution);
+  residual.sadd(-1., 1., rhs);
+  AssertThrow(residual.l2_norm() <= tolerance,
+              ExcMessage(prefix + "residual " + std::to_string(residual.l2_norm())));
+  check_equal(prefix + "mixed precision", solution, exact, 1.e-8);
+  std::cout << prefix << "residual below 1e-12 |b|" << std::endl;
+  // a(u, u) for the bubble function u in both blocks is 7/150 in 2D and 31/13500 in 3D
+  print_value(prefix + "mixed precision", "(x, b)", solution * rhs);
+
+  // a single inner iteration cannot reduce the residual by 1e-12 in float
+  typename SolverMixedPrecision<BlockVectorType, BlockVectorTypeFloat>::AdditionalData
+    additional_data;
+  additional_data.inner_reduction = 1.e-12;
+  additional_data.max_inner_iterations = 1;
+  SolverControl control_failing(100, tolerance);
+  SolverMixedPrecision<BlockVectorType, BlockVectorTypeFloat> solver_failing(control_failing,
+                                                                             additional_data);
+  solution = 0.;
+  bool thrown = false;
+  try
+  {
+    solver_failing.solve(op, op_float, solution, rhs, preconditioner);
+  }
+  catch (const SolverControl::NoConvergence&)
+  {
+    thrown = true;
+  }
+  AssertThrow(thrown, ExcMessage(prefix + "the failing inner solve was not reported"));
+  std::cout << prefix << "inner NoConvergence thrown" << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(0);
+  try
+  {
+    run<2>(3);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
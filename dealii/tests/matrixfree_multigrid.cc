@@ -0,0 +1,128 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// CG preconditioned by MGBlockPreconditioner, with the levels in float, for a system of two
+// Laplace blocks coupled by mass terms. The right hand side is the operator applied to the
+// interpolated bubble function, which the solver recovers, in a number of iterations that does
+// not grow with the refinement.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+#include <dealii/mg_block_preconditioner.h>
+
+#include <algorithm>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// the largest number of iterations, and by how much it may grow from the coarsest mesh
+constexpr unsigned int max_iterations = 20;
+constexpr unsigned int max_growth = 2;
+
+template <int dim>
+void
+run(const std::vector<unsigned int>& refinements)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_0(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_1(fe);
+  auto fe_datas = (fedata_0, fedata_1);
+  FEData<FE_Q, degree, 1, dim, 0, degree, float> fedata_0_level(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree, float> fedata_1_level(fe);
+  auto fe_datas_level = (fedata_0_level, fedata_1_level);
+
+  TestFunction<0, dim, 0> v_0;
+  TestFunction<0, dim, 1> v_1;
+  FEFunction<0, dim, 0> u_0("u_0");
+  FEFunction<0, dim, 1> u_1("u_1");
+  const auto forms = form(grad(u_0), grad(v_0)) + form(u_1, v_0) + form(grad(u_1), grad(v_1)) +
+                     form(u_0, v_1);
+
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  std::vector<unsigned int> n_iterations;
+  for (const unsigned int refine : refinements)
+  {
+    IntegratorFixture<dim> fixture(fe, refine);
+    fixture.make_zero_dirichlet_constraints();
+    fixture.reinit_blocks(2);
+    fixture.distribute_mg_dofs(true);
+
+    MatrixFreeIntegrator<dim, BlockVectorType, decltype(forms), decltype(fe_datas)> op;
+    op.initialize(fixture.data, forms, fe_datas);
+    MGBlockPreconditioner<dim, decltype(forms), decltype(fe_datas_level)> preconditioner;
+    preconditioner.initialize({ &fixture.dof, &fixture.dof },
+                              { fixture.mg_constrained_dofs, fixture.mg_constrained_dofs },
+                              forms,
+                              fe_datas_level);
+    preconditioner.update_smoothers();
+
+    const BlockVectorType exact = fixture.block_vector(2, Bubble<dim>());
+    BlockVectorType rhs(exact);
+    op.vmult(rhs, exact);
+    BlockVectorType solution(exact);
+    solution = 0.;
+
+    SolverControl control(100, 1.e-10 * rhs.l2_norm());
+    SolverCG<BlockVectorType> solver(control);
+    solver.solve(op, solution, rhs, preconditioner);
+    const std::string name = prefix + "refine " + std::to_string(refine);
+    check_equal(name, solution, exact, 1.e-8);
+    n_iterations.push_back(control.last_step());
+
+    // a(u, u) for the bubble function u in both blocks is 7/150 in 2D and 31/13500 in 3D
+    print_value(name, "(x, b)", solution * rhs);
+  }
+
+  const auto minmax = std::minmax_element(n_iterations.begin(), n_iterations.end());
+  AssertThrow(*minmax.second <= max_iterations && *minmax.second <= n_iterations[0] + max_growth,
+              ExcMessage(prefix + "between " + std::to_string(*minmax.first) + " and " +
+                         std::to_string(*minmax.second) + " iterations"));
+  std::cout << prefix << "at most " << max_iterations << " iterations, growing by at most "
+            << max_growth << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(0);
+  try
+  {
+    run<2>({ 3, 4, 5 });
+    run<3>({ 2, 3 });
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// The cell loop of vmult for block vectors with one thread per process, which overlaps the
+// ghost exchange of the blocks read by the form with the cell batches, compared with the
+// MatrixFree::cell_loop of vmult for several vectors. The set of exchanged blocks changes when
+// a block is bound to a vector or unbound, so the comparison is repeated after each.
+
+#include "test_integrator.h"
+
+#include <deal.II/distributed/tria.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <class Operator>
+void
+check(const std::string& name, const Operator& op, const BlockVectorType& src)
+{
+  BlockVectorType dst(src);
+  op.vmult(dst, src);
+  std::vector<BlockVectorType> dst_multiple{ src };
+  op.vmult(dst_multiple, std::vector<BlockVectorType>{ src });
+  check_equal(name, dst, dst_multiple[0]);
+
+  print_value(name, "(u_0, A_0 u)", dst.block(0) * src.block(0));
+  if (!op.is_bound(1))
+    print_value(name, "(u_1, A_1 u)", dst.block(1) * src.block(1));
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_0(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_1(fe);
+  auto fe_datas = (fedata_0, fedata_1);
+
+  TestFunction<0, dim, 0> v_0;
+  TestFunction<0, dim, 1> v_1;
+  FEFunction<0, dim, 0> u_0("u_0");
+  FEFunction<0, dim, 1> u_1("u_1");
+  const auto f_0 = form(grad(u_0), grad(v_0));
+  const auto f_1 = form(u_1 * u_0, v_0);
+  const auto f_2 = form(u_1, v_1);
+  const auto forms = f_0 + f_1 + f_2;
+
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(refine);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  typename ::dealii::MatrixFree<dim, double>::AdditionalData additional_data;
+  additional_data.tasks_parallel_scheme = ::dealii::MatrixFree<dim, double>::AdditionalData::none;
+  additional_data.mapping_update_flags = update_values | update_gradients | update_JxW_values;
+  const std::vector<const DoFHandler<dim>*> dofs{ &dof, &dof };
+  const std::vector<const ConstraintMatrix*> constraints_pointers{ &constraints, &constraints };
+  ::dealii::MatrixFree<dim, double> data;
+  data.reinit(dofs, constraints_pointers, QGauss<1>(degree + 1), additional_data);
+
+  MatrixFreeIntegrator<dim, BlockVectorType, decltype(forms), decltype(fe_datas)> op;
+  op.initialize(data, forms, fe_datas);
+
+  // u_0 = u_1 = x + y (+ z)
+  BlockVectorType src(2);
+  for (unsigned int b = 0; b < 2; ++b)
+  {
+    data.initialize_dof_vector(src.block(b), b);
+    VectorTools::interpolate(dof, SumOfCoordinates<dim>(), src.block(b));
+  }
+  src.collect_sizes();
+  VectorType bound = src.block(1);
+  bound *= 2.;
+
+  // (grad u_0, grad u_0) + (u_1 u_0, u_0) is 5 in 2D and 12 in 3D for u_1 = 2 (x + y (+ z)),
+  // 7/2 and 15/2 for u_1 = u_0, and (u_1, u_1) is 7/6 and 5/2
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  op.bind_fe_function(1, bound);
+  check(prefix + "bound", op, src);
+  op.unbind_fe_functions();
+  check(prefix + "unbound", op, src);
+  op.bind_fe_function(1, bound);
+  check(prefix + "bound again", op, src);
+}
+
+int
+main(int argc, char** argv)
+{
+  // one thread per process, such that vmult overlaps the ghost exchange with the cell loop
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  // all processes construct the forms, only the first one prints
+  if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) != 0)
+    std::cout.setstate(std::ios::failbit);
+  try
+  {
+    run<2>(4);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
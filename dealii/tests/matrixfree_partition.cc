@@ -0,0 +1,94 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// The cell loop with per-thread FEDatas: vmult gives the same result for every task parallel
+// scheme of MatrixFree, including the schemes running cell batches on several threads at once.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  TestFunction<0, dim, 0> v;
+  FEFunction<0, dim, 0> u("u");
+  const auto forms = form(grad(u), grad(v)) + form(u, v);
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  using AdditionalData = typename ::dealii::MatrixFree<dim, double>::AdditionalData;
+  const std::vector<std::pair<typename AdditionalData::TasksParallelScheme, std::string>>
+    schemes{ { AdditionalData::none, "none" },
+             { AdditionalData::partition_partition, "partition_partition" },
+             { AdditionalData::partition_color, "partition_color" },
+             { AdditionalData::color, "color" } };
+  VectorType reference;
+  for (const auto& scheme : schemes)
+  {
+    fixture.reinit(scheme.first);
+    MatrixFreeIntegrator<dim, VectorType, decltype(forms), decltype(fe_datas)> op;
+    op.initialize(fixture.data, forms, fe_datas);
+
+    const VectorType u_h = fixture.sum_of_coordinates();
+    VectorType result = fixture.vector();
+    op.vmult(result, u_h);
+    // (grad u, grad u) + (u, u) for u = x + y (+ z) is 19/6 in 2D and 11/2 in 3D
+    const std::string name = "dim " + std::to_string(dim) + ": " + scheme.second;
+    print_value(name, "(u, A u)", result * u_h);
+    if (scheme.first == AdditionalData::none)
+      reference = result;
+    else
+      check_equal(name, result, reference);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv);
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(4);
+    run<3>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// pow<N>(u) and polynomial(u, c_0, ..., c_n) at a quadrature point compared with std::pow and a
+// direct evaluation, with scalar factors folded into them, and their linearizations compared
+// with the derivatives. A stand-in for FEEvaluation provides u and the increment e.
+
+#include <cfl/dealii_matrixfree.h>
+#include <cfl/dealii_matrixfree_linearize.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// the values of u (index 0) and e (index 1) on the lanes of a VectorizedArray
+struct Values
+{
+  template <unsigned int idx>
+  VectorizedArray<double>
+  get_value(unsigned int /*q*/) const
+  {
+    VectorizedArray<double> value;
+    for (unsigned int l = 0; l < VectorizedArray<double>::n_array_elements; ++l)
+      value[l] = idx == 0 ? u(l) : 0.5 + l;
+    return value;
+  }
+
+  static double
+  u(const unsigned int lane)
+  {
+    return -1.5 + 0.7 * lane;
+  }
+};
+
+template <class Expression, class Reference>
+void
+check(const std::string& name, const Expression& expression, const Reference& reference)
+{
+  const Values values;
+  const VectorizedArray<double> value = expression.value(values, 0);
+  for (unsigned int l = 0; l < VectorizedArray<double>::n_array_elements; ++l)
+  {
+    const double exact = reference(Values::u(l), 0.5 + l);
+    const double error = std::abs(value[l] - exact) / std::max(std::abs(exact), 1.);
+    AssertThrow(error < 1.e-14, ExcMessage(name + " error " + std::to_string(error)));
+  }
+  std::cout << name << " OK" << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  try
+  {
+    FEFunction<0, 2, 0> u("u");
+    FEFunction<0, 2, 1> e("e");
+    TestFunction<0, 2, 0> v;
+
+    check("pow<1>(u)", pow<1>(u), [](double x, double) { return x; });
+    check("pow<2>(u)", pow<2>(u), [](double x, double) { return x * x; });
+    check("pow<3>(u)", pow<3>(u), [](double x, double) { return std::pow(x, 3); });
+    check("pow<7>(u)", pow<7>(u), [](double x, double) { return std::pow(x, 7); });
+    check("pow<4>(2 u)", pow<4>(2. * u), [](double x, double) { return std::pow(2. * x, 4); });
+    check("-pow<2>(u) e", -pow<2>(u) * e, [](double x, double y) { return -x * x * y; });
+    check("polynomial(u, 1, 2, 0, -1)", polynomial(u, 1., 2., 0., -1.),
+          [](double x, double) { return 1. + 2. * x - x * x * x; });
+    check("2 polynomial(3 u, 0, 1, 1)", polynomial(3. * u, 0., 1., 1.) * 2.,
+          [](double x, double) { return 2. * (3. * x + 9. * x * x); });
+
+    // d/du f(u) applied to the increment e
+    check("linearize pow<3>(u)", linearize<0, 1>(form(pow<3>(u), v)).expr,
+          [](double x, double y) { return 3. * x * x * y; });
+    check("linearize polynomial(u, 0, 2, 0, -1) - pow<2>(u)",
+          linearize<0, 1>(form(polynomial(u, 0., 2., 0., -1.) - pow<2>(u), v)).expr,
+          [](double x, double y) { return (2. - 3. * x * x - 2. * x) * y; });
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// Forms tested by grad(v) and by div(v) on the same block submit to the same gradient slot
+// of FEEvaluation, so the second one adds to the data submitted by the first. vmult of the
+// combined forms, in either order, is compared with the sum of vmult of the two forms applied
+// as separate operators.
+
+#include "test_integrator.h"
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <cfl/cfl.h>
+#include <cfl/dealii_matrixfree.h>
+
+#include <dealii/fe_data.h>
+#include <dealii/matrix_free_integrator.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+template <int dim, class FEDatasType, class FormType>
+VectorType
+apply(const IntegratorFixture<dim>& fixture, const FEDatasType& fe_datas, const FormType& forms,
+      const VectorType& src)
+{
+  MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType> op;
+  op.initialize(fixture.data, forms, fe_datas);
+  VectorType dst = fixture.vector();
+  op.vmult(dst, src);
+  return dst;
+}
+
+template <int dim>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int degree = 2;
+  FESystem<dim> fe(FE_Q<dim>(degree), dim);
+  FEData<FESystem, degree, dim, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  TestFunction<1, dim, 0> v;
+  FEFunction<1, dim, 0> u("u");
+  const auto f_grad = form(grad(u), grad(v));
+  const auto f_div = form(div(u), div(v));
+
+  IntegratorFixture<dim> fixture(fe, refine);
+  fixture.reinit();
+  const VectorType u_h = fixture.sum_of_coordinates();
+
+  VectorType reference = apply(fixture, fe_datas, f_grad, u_h);
+  reference += apply(fixture, fe_datas, f_div, u_h);
+
+  // (grad u, grad v) and (div u, div v) are both dim^2 for every component of u equal to
+  // x + y (+ z), so (u, A u) is 8 in 2D and 18 in 3D
+  const std::string prefix = "dim " + std::to_string(dim) + ": ";
+  const VectorType grad_div = apply(fixture, fe_datas, f_grad + f_div, u_h);
+  check_equal(prefix + "grad + div", grad_div, reference);
+  print_value(prefix + "grad + div", "(u, A u)", grad_div * u_h);
+  const VectorType div_grad = apply(fixture, fe_datas, f_div + f_grad, u_h);
+  check_equal(prefix + "div + grad", div_grad, reference);
+  print_value(prefix + "div + grad", "(u, A u)", div_grad * u_h);
+}
+
+int
+main(int argc, char** argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(3);
+    run<3>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,220 @@
+#ifndef _TEST_INTEGRATOR_H_
+#define _TEST_INTEGRATOR_H_
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+
+using namespace dealii;
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+using BlockVectorType = LinearAlgebra::distributed::BlockVector<double>;
+
+// The sum of the coordinates in every component. FE_Q interpolates it exactly, so (u, A u)
+// is the exact bilinear form of this polynomial and can be checked against its closed form.
+template <int dim>
+class SumOfCoordinates : public Function<dim>
+{
+public:
+  explicit SumOfCoordinates(const unsigned int n_components = 1)
+    : Function<dim>(n_components)
+  {
+  }
+
+  double
+  value(const Point<dim>& p, const unsigned int /*component*/ = 0) const override
+  {
+    double sum = 0.;
+    for (unsigned int d = 0; d < dim; ++d)
+      sum += p[d];
+    return sum;
+  }
+};
+
+// x(1-x) y(1-y) (z(1-z)), zero on the boundary and in Q_2
+template <int dim>
+class Bubble : public Function<dim>
+{
+public:
+  double
+  value(const Point<dim>& p, const unsigned int /*component*/ = 0) const override
+  {
+    double value = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      value *= p[d] * (1. - p[d]);
+    return value;
+  }
+};
+
+/**
+ * A globally refined unit cube with the DoFs of @p fe and the MatrixFree object of the
+ * MatrixFreeIntegrator tests. There are no constraints unless the test adds some before
+ * calling reinit().
+ */
+template <int dim>
+struct IntegratorFixture
+{
+  IntegratorFixture(const FiniteElement<dim>& fe, const unsigned int refine)
+    : dof(tria)
+  {
+    GridGenerator::hyper_cube(tria);
+    tria.refine_global(refine);
+    dof.distribute_dofs(fe);
+  }
+
+  // refine the first cell once more, such that the mesh has hanging nodes
+  void
+  refine_first_cell()
+  {
+    tria.begin_active()->set_refine_flag();
+    tria.execute_coarsening_and_refinement();
+    dof.distribute_dofs(dof.get_fe());
+  }
+
+  // hanging node constraints and zero Dirichlet values on the boundary
+  void
+  make_zero_dirichlet_constraints()
+  {
+    constraints.clear();
+    DoFTools::make_hanging_node_constraints(dof, constraints);
+    VectorTools::interpolate_boundary_values(dof, 0, ZeroFunction<dim>(), constraints);
+  }
+
+  void
+  reinit(const typename MatrixFree<dim, double>::AdditionalData::TasksParallelScheme scheme =
+           MatrixFree<dim, double>::AdditionalData::none)
+  {
+    constraints.close();
+    typename MatrixFree<dim, double>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme = scheme;
+    additional_data.tasks_block_size = 2;
+    additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+    data.reinit(dof, constraints, QGauss<1>(dof.get_fe().degree + 1), additional_data);
+  }
+
+  // the same DoFs and constraints for each of @p n_blocks FEFunctions, see block_sum_of_coordinates()
+  void
+  reinit_blocks(const unsigned int n_blocks)
+  {
+    reinit_blocks(n_blocks, data);
+  }
+
+  // like reinit_blocks(), but for another MatrixFree object, e.g. one in float
+  template <typename Number>
+  void
+  reinit_blocks(const unsigned int n_blocks, MatrixFree<dim, Number>& matrix_free)
+  {
+    constraints.close();
+    typename MatrixFree<dim, Number>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme = MatrixFree<dim, Number>::AdditionalData::none;
+    additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+    const std::vector<const DoFHandler<dim>*> dofs(n_blocks, &dof);
+    const std::vector<const ConstraintMatrix*> constraints_pointers(n_blocks, &constraints);
+    matrix_free.reinit(
+      dofs, constraints_pointers, QGauss<1>(dof.get_fe().degree + 1), additional_data);
+  }
+
+  // the level DoFs of the multigrid tests, with zero Dirichlet values on the boundary of the
+  // levels if @p dirichlet is set
+  void
+  distribute_mg_dofs(const bool dirichlet)
+  {
+    dof.distribute_mg_dofs(dof.get_fe());
+    mg_constrained_dofs.initialize(dof);
+    if (dirichlet)
+      mg_constrained_dofs.make_zero_boundary_constraints(dof, std::set<types::boundary_id>{ 0 });
+  }
+
+  // a vector with the layout of the MatrixFree object
+  VectorType
+  vector() const
+  {
+    VectorType vector;
+    data.initialize_dof_vector(vector);
+    return vector;
+  }
+
+  // the interpolation of SumOfCoordinates
+  VectorType
+  sum_of_coordinates() const
+  {
+    VectorType vector = this->vector();
+    VectorTools::interpolate(dof, SumOfCoordinates<dim>(dof.get_fe().n_components()), vector);
+    return vector;
+  }
+
+  // the interpolation of @p function in each of @p n_blocks blocks
+  BlockVectorType
+  block_vector(const unsigned int n_blocks, const Function<dim>& function) const
+  {
+    BlockVectorType vector(n_blocks);
+    for (unsigned int b = 0; b < n_blocks; ++b)
+    {
+      data.initialize_dof_vector(vector.block(b), b);
+      VectorTools::interpolate(dof, function, vector.block(b));
+    }
+    vector.collect_sizes();
+    return vector;
+  }
+
+  // the interpolation of SumOfCoordinates in each of @p n_blocks blocks
+  BlockVectorType
+  block_sum_of_coordinates(const unsigned int n_blocks) const
+  {
+    return block_vector(n_blocks, SumOfCoordinates<dim>(dof.get_fe().n_components()));
+  }
+
+  Triangulation<dim> tria;
+  DoFHandler<dim> dof;
+  ConstraintMatrix constraints;
+  MatrixFree<dim, double> data;
+  MGConstrainedDoFs mg_constrained_dofs;
+};
+
+// (u, A u)
+template <class Operator>
+double
+energy(const Operator& op, const VectorType& u)
+{
+  VectorType Au;
+  op.initialize_dof_vector(Au);
+  op.vmult(Au, u);
+  return Au * u;
+}
+
+// print a value compared by a test, with few enough digits to be independent of round-off
+inline void
+print_value(const std::string& name, const std::string& label, const double value)
+{
+  std::cout << name << ": " << label << " = " << std::setprecision(6) << value << std::endl;
+}
+
+// throw if @p result differs from @p reference by more than @p tolerance relative to it
+template <class Vector>
+void
+check_equal(const std::string& name, const Vector& result, const Vector& reference,
+            const double tolerance = 1.e-12)
+{
+  Vector difference = result;
+  difference -= reference;
+  const double relative_error = difference.l2_norm() / reference.l2_norm();
+  AssertThrow(relative_error < tolerance,
+              ExcMessage(name + ": relative error " + std::to_string(relative_error)));
+}
+
+#endif
@@ -34,11 +34,15 @@ struct FEfunctor
     FEFunction<obj_comb[i].rank, obj_comb[i].dim, obj_comb[i].index> test_fe_fun_obj1_2(
       "test_fe_fun_obj1_2"); // one form of const
     FEFunction<obj_comb[i].rank, obj_comb[i].dim, obj_comb[i].index> test_fe_fun_obj1(
-      "test_fe_fun_obj1", obj_comb[i].scalar_factor); // second form of const
+      "test_fe_fun_obj1");
+    // scalar factors other than one are kept by a ScaledFEFunction
+    const auto test_scaled_obj = test_fe_fun_obj1 * obj_comb[i].scalar_factor;
     // Check basic state of object
     BOOST_TEST(test_fe_fun_obj1.index == obj_comb[i].index);
     BOOST_TEST(test_fe_fun_obj1.name() == "test_fe_fun_obj1");
-    BOOST_TEST(test_fe_fun_obj1.scalar_factor == obj_comb[i].scalar_factor);
+    BOOST_TEST(test_fe_fun_obj1.scalar_factor == 1.);
+    BOOST_TEST(test_scaled_obj.scalar_factor == obj_comb[i].scalar_factor);
+    BOOST_TEST(test_scaled_obj.get_unscaled().name() == "test_fe_fun_obj1");
 
     auto test_grad_obj = grad(test_fe_fun_obj1);
     BOOST_TEST(test_grad_obj.index == test_fe_fun_obj1.index);